@@ -5,15 +5,17 @@
 #include Defines.glsl
 // -------------------------------------------- //
 
+// Positions and normals come from one shared stream, the scalar from
+// a second stream that is swapped when the coloring mode changes
 layout (location = 0) in vec3  a_Position;
 layout (location = 1) in vec3  a_Normal;
-layout (location = 2) in vec3  a_Color; 
+layout (location = 2) in float a_Scalar;
 
 
 struct VS_OUT
 {
 	vec3 FragPos;
-	vec3 Color;
+	float Scalar;
 	vec4 FragPosViewSpace;
 	vec3 Normal;
 	vec2 TexCoords;
@@ -36,7 +38,7 @@ void main()
 	
 
 	vs_out.FragPos = vec3(u_Model * vec4(a_Position, 1.0));
-	vs_out.Color = a_Color;
+	vs_out.Scalar = a_Scalar;
 	vs_out.FragPosViewSpace = u_View * vec4(vs_out.FragPos, 1.0);
 	vs_out.Normal  = N;
 
@@ -56,7 +58,7 @@ layout(location = 0) out vec4 FragColor;
 struct VS_OUT
 {
 	vec3 FragPos;
-	vec3 Color;
+	float Scalar;
 	vec4 FragPosViewSpace;
 	vec3 Normal;
 	vec2 TexCoords;
@@ -65,13 +67,30 @@ struct VS_OUT
 
 layout (location = 0) in VS_OUT fs_in;
 
+// Where the color of a fragment comes from
+#define COLOR_SOURCE_ALBEDO 0
+#define COLOR_SOURCE_VERTEX 1
+#define COLOR_SOURCE_FACE   2
+
 layout (location = 0) uniform float u_Roughness;
 layout (location = 1) uniform float u_Metalness;
+layout (location = 2) uniform vec3 u_Albedo;
+layout (location = 3) uniform int u_ColorSource;
+layout (location = 4) uniform int u_FlatShading;
+// Scalars are raw values, they are mapped to [0, 1] with this range
+// in the shader so changing it does not touch any buffer
+layout (location = 5) uniform float u_ScalarMin;
+layout (location = 6) uniform float u_ScalarMax;
+layout (location = 7) uniform int u_ColormapIndex;
 
 layout (binding = 0) uniform samplerCube u_IrradianceMap;
 layout (binding = 1) uniform samplerCube u_PrefilterMap;
 layout (binding = 2) uniform sampler2D u_BrdfLUT;
 layout (binding = 3) uniform sampler2D u_BayerDithering;
+// Each row is a 1D colormap, u_ColormapIndex selects the row
+layout (binding = 4) uniform sampler2D u_Colormaps;
+// One scalar per triangle, indexed with gl_PrimitiveID
+layout (binding = 5) uniform samplerBuffer u_FaceScalars;
 
 // ------------- GLOBAL VARIABLES ------------- //
 #include GlobalVariables.glsl
@@ -83,6 +102,18 @@ layout (binding = 3) uniform sampler2D u_BayerDithering;
 #include PbrFunctions.glsl
 // -------------------------------------------- //
 
+vec3 MapScalar(float scalar)
+{
+	float range = max(u_ScalarMax - u_ScalarMin, 1e-12);
+	float t = clamp((scalar - u_ScalarMin) / range, 0.0, 1.0);
+
+	// Sample texel centers so both ends of the range get the end colors
+	vec2 size = vec2(textureSize(u_Colormaps, 0));
+	vec2 uv = vec2((t * (size.x - 1.0) + 0.5) / size.x, (float(u_ColormapIndex) + 0.5) / size.y);
+
+	return texture(u_Colormaps, uv).rgb;
+}
+
 void main()
 {
 
@@ -91,12 +122,23 @@ void main()
 	vec3 viewDir = u_ViewPos - fs_in.FragPos;
 
 
-	vec3 color      = fs_in.Color;
+	vec3 color = u_Albedo;
+
+	if (u_ColorSource == COLOR_SOURCE_VERTEX)
+		color = MapScalar(fs_in.Scalar);
+	else if (u_ColorSource == COLOR_SOURCE_FACE)
+		color = MapScalar(texelFetch(u_FaceScalars, gl_PrimitiveID).r);
+
 	float roughness = u_Roughness;
 	float metalness = u_Metalness;
 	// float ao = texture(u_AoMap, texCoords * u_TilingFactor).r;
 
+	// Flat shading takes the face normal from the screen space
+	// derivatives of the position instead of duplicated vertices
 	vec3 normal = fs_in.Normal;
+	if (u_FlatShading != 0)
+		normal = normalize(cross(dFdx(fs_in.FragPos), dFdy(fs_in.FragPos)));
+
 	// normal = normalize(normalize(fs_in.TBN * normal));
 
 	vec3 reflectionVec = normalize(reflect(-viewDir, normal)); 
@@ -129,7 +171,7 @@ void main()
 	vec3 kD = vec3(1.0) - kS;
 	kD *= 1.0 - metalness;
 
-	float backFacingFactor = dot(normalize(fs_in.Normal), lightDir) > 0 ? 1.0 : 0.0;
+	float backFacingFactor = dot(normal, lightDir) > 0 ? 1.0 : 0.0;
 
 	float NdotL = max(dot(normal, lightDir), 0.0);
 
@@ -0,0 +1,135 @@
+#include <Precomp.h>
+#include <Benchmark/ClothBenchmark.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+
+#include <Cloth/ClothKernels.h>
+
+namespace GP
+{
+	// Same layout as Cloth, with the top row pinned and every particle
+	// moved off its rest position
+	static void BuildGrid(uint32_t side, uint32_t seed, ClothParticles& particles, ClothConstraints& constraints)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+
+		float spacing = 1.0f / (float)(side - 1);
+
+		particles.Resize(side * side);
+		for (uint32_t i = 0; i < side; i++)
+		{
+			for (uint32_t j = 0; j < side; j++)
+			{
+				uint32_t id = i * side + j;
+				particles.Reset(id, glm::vec3(j + jitter(generator), i + jitter(generator), jitter(generator)) * spacing);
+				particles.inverseMass[id] = (i == side - 1) ? 0.0f : 1.0f;
+			}
+		}
+
+		constraints.Clear();
+		for (uint32_t i = 0; i < side; i++)
+		{
+			for (uint32_t j = 0; j < side; j++)
+			{
+				uint32_t id = i * side + j;
+
+				if (j + 1 < side)
+					constraints.Add(id, id + 1, spacing);
+				if (i + 1 < side)
+					constraints.Add(id, id + side, spacing);
+			}
+		}
+
+		constraints.Color(side * side);
+	}
+
+	// Runs the solver steps with one kernel set and adds the time spent
+	// in projection and integration
+	static void RunSteps(const ClothKernels& kernels, bool xpbd, const ClothBenchmarkSpecs& specs, const VerletSpecs& verlet,
+		ClothParticles& particles, ClothConstraints& constraints, float& projectTime, float& integrateTime)
+	{
+		for (uint32_t step = 0; step < specs.stepCount; step++)
+		{
+			Timer projectTimer;
+			if (xpbd)
+				constraints.ResetMultipliers(0, constraints.GetCount());
+
+			for (uint32_t iteration = 0; iteration < specs.constraintIterations; iteration++)
+			{
+				for (uint32_t color = 0; color < constraints.GetColorCount(); color++)
+				{
+					uint32_t begin = constraints.GetColorBegin(color);
+					uint32_t end = constraints.GetColorEnd(color);
+
+					const ClothKernels& colorKernels = constraints.IsSerialColor(color) ? ClothKernels::Get(SimdLevel::SCALAR) : kernels;
+					if (xpbd)
+						colorKernels.projectConstraintsXPBD(particles, constraints, begin, end, verlet.timeStep);
+					else
+						colorKernels.projectConstraints(particles, constraints, begin, end);
+				}
+			}
+			projectTime += projectTimer.ElapsedMilliseconds();
+
+			Timer integrateTimer;
+			kernels.integrate(particles, 0, particles.GetCount(), verlet);
+			integrateTime += integrateTimer.ElapsedMilliseconds();
+		}
+	}
+
+	void ClothBenchmark::Run(const ClothBenchmarkSpecs& specs)
+	{
+		GP_INFO("Cloth kernel benchmark, {0} steps of {1} constraint iterations on one thread", specs.stepCount, specs.constraintIterations);
+
+		VerletSpecs verlet;
+
+		for (uint32_t side : specs.gridSizes)
+		{
+			ClothParticles initial;
+			ClothConstraints constraints;
+			BuildGrid(side, specs.seed, initial, constraints);
+
+			GP_INFO("\t{0}x{0} grid ({1} constraints in {2} colors)", side, constraints.GetCount(), constraints.GetColorCount());
+
+			constraints.SetCompliance(ClothConstraintType::STRUCTURAL, specs.compliance);
+
+			for (bool xpbd : { false, true })
+			{
+				ClothParticles reference;
+				float scalarTime = 0.0f;
+
+				for (int level = (int)SimdLevel::SCALAR; level <= (int)SimdLevel::AVX2; level++)
+				{
+					if (!ClothKernels::IsSupported((SimdLevel)level))
+					{
+						GP_INFO("\t\t{0:<4} {1:<8} not supported", xpbd ? "XPBD" : "PBD", ClothKernels::GetName((SimdLevel)level));
+						continue;
+					}
+
+					const ClothKernels& kernels = ClothKernels::Get((SimdLevel)level);
+					ClothParticles particles = initial;
+
+					float projectTime = 0.0f;
+					float integrateTime = 0.0f;
+					RunSteps(kernels, xpbd, specs, verlet, particles, constraints, projectTime, integrateTime);
+
+					float totalTime = (projectTime + integrateTime) / specs.stepCount;
+
+					if (level == (int)SimdLevel::SCALAR)
+					{
+						reference = particles;
+						scalarTime = totalTime;
+					}
+
+					float maxDifference = 0.0f;
+					for (uint32_t i = 0; i < particles.GetCount(); i++)
+						maxDifference = std::max(maxDifference, glm::length(particles.GetPosition(i) - reference.GetPosition(i)));
+
+					GP_INFO("\t\t{0:<4} {1:<8} project {2:>8.3f} ms    integrate {3:>8.3f} ms    speedup {4:>5.2f}x    max difference {5}",
+						xpbd ? "XPBD" : "PBD", kernels.GetName(kernels.level), projectTime / specs.stepCount,
+						integrateTime / specs.stepCount, scalarTime / totalTime, maxDifference);
+				}
+			}
+		}
+	}
+}
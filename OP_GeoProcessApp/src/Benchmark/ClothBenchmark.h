@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+namespace GP
+{
+	struct ClothBenchmarkSpecs
+	{
+		// Particles per side of the square grids
+		std::vector<uint32_t> gridSizes = { 64, 128, 256, 512, 1024 };
+
+		// Solver steps timed per kernel set, each one projects every
+		// constraint color constraintIterations times and integrates once
+		uint32_t stepCount = 20;
+		uint32_t constraintIterations = 3;
+
+		// Compliance of the constraints in the XPBD runs, the default of
+		// the structural constraints in ClothSettings
+		float compliance = 0.0f;
+
+		uint32_t seed = 0;
+	};
+
+	// Times the integration and the PBD and XPBD constraint projection
+	// kernels of every instruction set the CPU supports against the
+	// scalar ones on one thread, on jittered grids so the constraints
+	// have work to do, and reports the largest position difference from
+	// the scalar results of the same solver.
+	class ClothBenchmark
+	{
+	public:
+		static void Run(const ClothBenchmarkSpecs& specs = ClothBenchmarkSpecs());
+	};
+}
@@ -0,0 +1,316 @@
+#include <Precomp.h>
+#include <Benchmark/GeodesicBenchmark.h>
+
+#include <GeoProcess/System/ResourceSystem/ResourceManager.h>
+#include <GeoProcess/System/Profiling/Timer.h>
+
+#include <MeshOperations/EditorMesh.h>
+#include <MeshOperations/GeodesicSolver.h>
+#include <MeshOperations/ExactGeodesicSolver.h>
+#include <MeshOperations/HeatGeodesicSolver.h>
+
+namespace GP
+{
+	void GeodesicBenchmark::Run(const GeodesicBenchmarkSpecs& specs)
+	{
+		GP_INFO("Geodesic distance benchmark, {0} sources per model", specs.sourceCount);
+
+		for (const std::string& name : specs.modelNames)
+		{
+			Ref<Model> model = ResourceManager::GetModel(name);
+			if (!model || model->GetName() != name)
+			{
+				GP_WARN("\tModel {0} is not loaded, skipping", name);
+				continue;
+			}
+
+			Ref<EditorMesh> mesh = EditorMesh::Create(model);
+			const VertexAdjacency& adjacency = mesh->GetAdjacency();
+			uint32_t vertexCount = adjacency.GetVertexCount();
+			uint32_t sourceCount = std::min(specs.sourceCount, vertexCount);
+
+			std::vector<uint32_t> sources(sourceCount);
+			for (uint32_t i = 0; i < sourceCount; i++)
+				sources[i] = (uint32_t)((uint64_t)i * vertexCount / sourceCount);
+
+			// Reference distances for every source
+			DijkstraSolver solver(adjacency);
+			std::vector<std::vector<float>> reference(sourceCount);
+
+			Timer solverTimer;
+			for (uint32_t i = 0; i < sourceCount; i++)
+			{
+				solver.ComputeDistances(sources[i]);
+				reference[i] = solver.GetDistances();
+			}
+			float solverTime = solverTimer.ElapsedMilliseconds() / sourceCount;
+
+			GP_INFO("\t{0} ({1} vertices)", name, vertexCount);
+			GP_INFO("\t\t{0:<14} {1:>10.3f} ms", "DijkstraSolver", solverTime);
+
+			for (int method = 0; method < 3; method++)
+			{
+				mesh->m_GeodesicDistanceCalcMethod = method;
+
+				if (method == 1 && vertexCount > specs.maxArrayVertexCount)
+				{
+					GP_INFO("\t\t{0:<14} skipped", mesh->GiveCalcMethodName());
+					continue;
+				}
+
+				float totalTime = 0.0f;
+				float maxError = 0.0f;
+
+				for (uint32_t i = 0; i < sourceCount; i++)
+				{
+					Timer timer;
+					const std::vector<VertexNode>& nodes = mesh->RunGeodesicDistances(sources[i]);
+					totalTime += timer.ElapsedMilliseconds();
+
+					for (uint32_t v = 0; v < vertexCount; v++)
+						maxError = std::max(maxError, std::abs(nodes[v].shortestPathEstimate - reference[i][v]));
+				}
+
+				GP_INFO("\t\t{0:<14} {1:>10.3f} ms    max error {2}", mesh->GiveCalcMethodName(), totalTime / sourceCount, maxError);
+			}
+		}
+	}
+
+	void GeodesicBenchmark::RunAccuracy(const GeodesicBenchmarkSpecs& specs)
+	{
+		GP_INFO("Exact geodesic accuracy benchmark, {0} sources per model", specs.exactSourceCount);
+
+		// Jittered planar grid with random diagonals, the border is kept
+		// straight so the domain stays convex
+		{
+			uint32_t resolution = std::max(2u, specs.planeResolution);
+			std::mt19937 generator(1234);
+			std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+
+			std::vector<glm::vec3> vertices;
+			std::vector<uint32_t> indices;
+
+			for (uint32_t y = 0; y < resolution; y++)
+			{
+				for (uint32_t x = 0; x < resolution; x++)
+				{
+					bool inner = x > 0 && y > 0 && x < resolution - 1 && y < resolution - 1;
+					vertices.push_back(glm::vec3(x + (inner ? jitter(generator) : 0.0f), y + (inner ? jitter(generator) : 0.0f), 0.0f));
+				}
+			}
+
+			for (uint32_t y = 0; y < resolution - 1; y++)
+			{
+				for (uint32_t x = 0; x < resolution - 1; x++)
+				{
+					uint32_t a = y * resolution + x;
+					uint32_t b = a + 1;
+					uint32_t c = a + resolution;
+					uint32_t d = c + 1;
+
+					if (generator() % 2)
+						indices.insert(indices.end(), { a, b, d, a, d, c });
+					else
+						indices.insert(indices.end(), { a, b, c, b, d, c });
+				}
+			}
+
+			HalfEdgeMesh halfEdgeMesh(vertices.size(), indices);
+			ExactGeodesicSolver solver(halfEdgeMesh, vertices);
+
+			uint32_t source = (resolution / 2) * resolution + resolution / 2;
+			solver.ComputeDistances(source);
+
+			float maxError = 0.0f;
+			for (uint32_t v = 0; v < vertices.size(); v++)
+				maxError = std::max(maxError, std::abs(solver.GetDistances()[v] - glm::length(vertices[v] - vertices[source])));
+
+			GP_INFO("\tPlane ({0} vertices) max error against straight lines {1}", vertices.size(), maxError);
+		}
+
+		for (const std::string& name : specs.modelNames)
+		{
+			Ref<Model> model = ResourceManager::GetModel(name);
+			if (!model || model->GetName() != name)
+			{
+				GP_WARN("\tModel {0} is not loaded, skipping", name);
+				continue;
+			}
+
+			ModelMesh modelMesh = model->GetMesh(0);
+			const std::vector<glm::vec3> vertices = modelMesh.Mesh->GetVertices();
+			const std::vector<uint32_t> indices = modelMesh.Mesh->GetIndicesVector();
+			uint32_t vertexCount = vertices.size();
+
+			HalfEdgeMesh halfEdgeMesh(vertexCount, indices);
+			VertexAdjacency adjacency(vertices, indices);
+
+			ExactGeodesicSolver exactSolver(halfEdgeMesh, vertices);
+			DijkstraSolver dijkstraSolver(adjacency);
+			HeatGeodesicSolver heatSolver(halfEdgeMesh, vertices);
+
+			uint32_t sourceCount = std::min(specs.exactSourceCount, vertexCount);
+
+			float exactTime = 0.0f;
+			float dijkstraTime = 0.0f;
+			float heatTime = 0.0f;
+			uint64_t windowCount = 0;
+
+			// Relative amount by which the edge graph overestimates the
+			// surface distance, exact distances above the graph ones
+			// would be an error of the solver
+			double meanOverestimate = 0.0;
+			double maxOverestimate = 0.0;
+			uint64_t sampleCount = 0;
+			uint32_t violations = 0;
+
+			// Heat method error relative to the exact distance
+			double meanHeatError = 0.0;
+			double maxHeatError = 0.0;
+
+			for (uint32_t i = 0; i < sourceCount; i++)
+			{
+				uint32_t source = (uint32_t)((uint64_t)i * vertexCount / sourceCount);
+
+				Timer exactTimer;
+				exactSolver.ComputeDistances(source);
+				exactTime += exactTimer.ElapsedMilliseconds();
+				windowCount += exactSolver.GetWindowCount();
+
+				Timer dijkstraTimer;
+				dijkstraSolver.ComputeDistances(source);
+				dijkstraTime += dijkstraTimer.ElapsedMilliseconds();
+
+				Timer heatTimer;
+				heatSolver.ComputeDistances(source);
+				heatTime += heatTimer.ElapsedMilliseconds();
+
+				const std::vector<float>& exact = exactSolver.GetDistances();
+				const std::vector<float>& graph = dijkstraSolver.GetDistances();
+				const std::vector<float>& heat = heatSolver.GetDistances();
+
+				for (uint32_t v = 0; v < vertexCount; v++)
+				{
+					if (exact[v] <= 0.0f || exact[v] == std::numeric_limits<float>::max())
+						continue;
+
+					if (exact[v] > graph[v] * (1.0f + 1e-5f))
+						violations++;
+
+					double overestimate = (graph[v] - exact[v]) / exact[v];
+					meanOverestimate += overestimate;
+					maxOverestimate = std::max(maxOverestimate, overestimate);
+
+					double heatError = std::abs(heat[v] - exact[v]) / exact[v];
+					meanHeatError += heatError;
+					maxHeatError = std::max(maxHeatError, heatError);
+					sampleCount++;
+				}
+			}
+
+			if (sampleCount > 0)
+			{
+				meanOverestimate /= sampleCount;
+				meanHeatError /= sampleCount;
+			}
+
+			GP_INFO("\t{0} ({1} vertices, {2} faces)", name, vertexCount, halfEdgeMesh.GetFaceCount());
+			GP_INFO("\t\tExact {0:.1f} ms, {1} windows per source, Dijkstra {2:.3f} ms",
+				exactTime / sourceCount, windowCount / sourceCount, dijkstraTime / sourceCount);
+			GP_INFO("\t\tDijkstra overestimates by {0:.2f}% on average, {1:.2f}% at most, {2} vertices below exact",
+				meanOverestimate * 100.0, maxOverestimate * 100.0, violations);
+			GP_INFO("\t\tHeat method {0:.3f} ms after a {1:.1f} ms factorization, {2:.2f}% error on average, {3:.2f}% at most",
+				heatTime / sourceCount, heatSolver.GetFactorizationTime(), meanHeatError * 100.0, maxHeatError * 100.0);
+		}
+	}
+
+	void GeodesicBenchmark::RunSpectral(const GeodesicBenchmarkSpecs& specs)
+	{
+		GP_INFO("Spectral descriptor benchmark, {0} eigenfunctions, {1} sources per model", specs.spectralBasisSize, specs.sourceCount);
+
+		for (const std::string& name : specs.modelNames)
+		{
+			Ref<Model> model = ResourceManager::GetModel(name);
+			if (!model || model->GetName() != name)
+			{
+				GP_WARN("\tModel {0} is not loaded, skipping", name);
+				continue;
+			}
+
+			Ref<EditorMesh> mesh = EditorMesh::Create(model);
+			const VertexAdjacency& adjacency = mesh->GetAdjacency();
+			uint32_t vertexCount = adjacency.GetVertexCount();
+			uint32_t sourceCount = std::min(specs.sourceCount, vertexCount);
+
+			// Read from the output directory when an earlier run cached it
+			Timer basisTimer;
+			Ref<SpectralBasis> basis = mesh->GetSpectralBasis(specs.spectralBasisSize);
+			float basisTime = basisTimer.ElapsedMilliseconds();
+
+			if (!basis)
+			{
+				GP_WARN("\t{0}: the eigensolver did not converge, skipping", name);
+				continue;
+			}
+
+			DijkstraSolver solver(adjacency);
+			std::vector<float> spectral(vertexCount);
+
+			float dijkstraTime = 0.0f;
+			float spectralTime = 0.0f;
+
+			// Pearson correlation over every source and vertex
+			double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumYY = 0.0, sumXY = 0.0;
+			uint64_t sampleCount = 0;
+
+			for (uint32_t i = 0; i < sourceCount; i++)
+			{
+				uint32_t source = (uint32_t)((uint64_t)i * vertexCount / sourceCount);
+
+				Timer dijkstraTimer;
+				solver.ComputeDistances(source);
+				dijkstraTime += dijkstraTimer.ElapsedMilliseconds();
+
+				Timer spectralTimer;
+				basis->ComputeDistances(source, SpectralDistance::BIHARMONIC, 0.0f, spectral.data());
+				spectralTime += spectralTimer.ElapsedMilliseconds();
+
+				const std::vector<float>& graph = solver.GetDistances();
+				for (uint32_t v = 0; v < vertexCount; v++)
+				{
+					if (graph[v] == std::numeric_limits<float>::max())
+						continue;
+
+					sumX += graph[v];
+					sumY += spectral[v];
+					sumXX += (double)graph[v] * graph[v];
+					sumYY += (double)spectral[v] * spectral[v];
+					sumXY += (double)graph[v] * spectral[v];
+					sampleCount++;
+				}
+			}
+
+			double correlation = 0.0;
+			if (sampleCount > 0)
+			{
+				double n = (double)sampleCount;
+				double covariance = sumXY - sumX * sumY / n;
+				double variance = (sumXX - sumX * sumX / n) * (sumYY - sumY * sumY / n);
+				correlation = variance > 0.0 ? covariance / std::sqrt(variance) : 0.0;
+			}
+
+			// One signature covers every vertex, its geodesic counterpart
+			// is an average distance pass from sourceCount sources
+			Timer signatureTimer;
+			std::vector<float> signature = basis->ComputeHeatKernelSignature(1.0f / basis->GetEigenvalues()(basis->GetBasisSize() - 1));
+			float signatureTime = signatureTimer.ElapsedMilliseconds();
+
+			GP_INFO("\t{0} ({1} vertices)", name, vertexCount);
+			GP_INFO("\t\tBasis of {0} functions {1:.1f} ms", basis->GetBasisSize(), basisTime);
+			GP_INFO("\t\tBiharmonic {0:.3f} ms, Dijkstra {1:.3f} ms per source, correlation {2:.3f}",
+				spectralTime / sourceCount, dijkstraTime / sourceCount, correlation);
+			GP_INFO("\t\tHeat kernel signature {0:.3f} ms, average geodesic distance {1:.3f} ms",
+				signatureTime, dijkstraTime);
+		}
+	}
+}
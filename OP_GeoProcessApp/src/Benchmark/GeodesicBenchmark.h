@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace GP
+{
+	struct GeodesicBenchmarkSpecs
+	{
+		// Bundled .off models, the ones that are not loaded are skipped
+		std::vector<std::string> modelNames = { "horse0", "man0", "neptune", "man3", "centaur", "gorilla", "cat", "woman", "man2" };
+
+		// Sources are spread evenly over the vertex indices so every
+		// method sees the same queries
+		uint32_t sourceCount = 8;
+
+		// The array method is quadratic, it is left out above this size
+		uint32_t maxArrayVertexCount = 20000;
+
+		// Exact distances take seconds per source on the large models
+		uint32_t exactSourceCount = 2;
+
+		// Side of the jittered planar grid used as an analytic reference,
+		// exact geodesics on it are straight line distances
+		uint32_t planeResolution = 64;
+
+		// Laplace-Beltrami eigenfunctions used by the spectral descriptors
+		uint32_t spectralBasisSize = 100;
+	};
+
+	// Times the single source geodesic distance methods of EditorMesh
+	// (m_GeodesicDistanceCalcMethod) on the same sources and reports the
+	// largest difference of each one from DijkstraSolver, whose results
+	// are exact on the edge graph.
+	class GeodesicBenchmark
+	{
+	public:
+		static void Run(const GeodesicBenchmarkSpecs& specs = GeodesicBenchmarkSpecs());
+
+		// Compares ExactGeodesicSolver with the edge graph distances of
+		// DijkstraSolver on the same models, plus against the analytic
+		// distances of a planar grid. The heat method error is reported
+		// against the exact distances as well
+		static void RunAccuracy(const GeodesicBenchmarkSpecs& specs = GeodesicBenchmarkSpecs());
+
+		// Gets the eigenbasis of every model through the cache of
+		// EditorMesh::GetSpectralBasis and times the spectral descriptors
+		// against their edge graph counterparts. Biharmonic distances are
+		// compared with DijkstraSolver by their correlation, the scales
+		// of the two differ
+		static void RunSpectral(const GeodesicBenchmarkSpecs& specs = GeodesicBenchmarkSpecs());
+	};
+}
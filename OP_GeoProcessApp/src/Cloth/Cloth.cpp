@@ -4,6 +4,8 @@
 #include <Math/Math.h>
 
 #include <GeoProcess/System/RenderSystem/RenderCommand.h>
+#include <GeoProcess/System/Profiling/Timer.h>
+#include <GeoProcess/System/Utils/ParallelFor.h>
 #include <glad/glad.h>
 #include <math.h>
 
@@ -11,137 +13,327 @@ namespace GP
 {
 	// Size will be divided into divisor amount of
 	// sectors
-	Cloth::Cloth(uint32_t size, uint32_t divisor)
+	Cloth::Cloth(uint32_t size, uint32_t divisor, const ClothSettings& settings) : m_Settings(settings)
 	{
+		m_Kernels = &ClothKernels::Get();
+
 		InitializeArrayBuffer(size, divisor);
 		SetupMesh();
 	}
 
-	Ref<Cloth> Cloth::Create(uint32_t size, uint32_t divisor)
+	Ref<Cloth> Cloth::Create(uint32_t size, uint32_t divisor, const ClothSettings& settings)
 	{
-		return std::make_shared<Cloth>(size, divisor);
+		return std::make_shared<Cloth>(size, divisor, settings);
 	}
 
 	void Cloth::InitializeArrayBuffer(uint32_t size, uint32_t divisor)
 	{
-		m_ArrayBuffer.clear();
+		uint32_t side = divisor + 1;
+		uint32_t particleCount = side * side;
 
 		double step = (double)size / (double)divisor;
-
 		double halfSize = (double)size / 2.0;
 
-		int i = 0;
-		int j = 0;
+		m_Side = side;
+		m_Spacing = (float)step;
+
+		m_Particles.Resize(particleCount);
+		m_Normals.assign(particleCount, glm::vec3(0.0f, 0.0f, 1.0f));
+		m_TexCoords.resize(particleCount);
 
-		int id = 0;
 		// Cloth will be initialized at xy plane so
-		// z coords will always be 0
-		for (double y = -halfSize, i=0; i <= divisor; y += step, i++)
+		// z coords will always be 0, the top row is pinned
+		for (uint32_t i = 0; i < side; i++)
 		{
-			for (double x = -halfSize, j=0; j <= divisor; x += step, j++)
+			for (uint32_t j = 0; j < side; j++)
 			{
-				ClothVertex v;
-				v.Pos = glm::vec3(x, y, 0.0f);
-				v.Normal = glm::vec3(0.0f, 0.0f, 1.0f);
-				v.TexCoord = glm::vec2((x + halfSize) / size, (y + halfSize) / size);
-				m_ArrayBuffer.push_back(v);
-
-				ClothParticle p;
-				p.acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
-				p.mass = 1.0f;
-				p.id = id;
-				p.moving = (i==divisor) ? false : true;
-				p.pos = glm::vec3(x, y, 0.0f);
-				p.oldPos = glm::vec3(x, y, 0.0f);
-				p.normal = glm::vec3(0.0f, 0.0f, 1.0f);
-
-				m_ClothParticles.push_back(p);
-				id++;
+				double x = -halfSize + j * step;
+				double y = -halfSize + i * step;
+
+				uint32_t id = i * side + j;
+				m_Particles.Reset(id, glm::vec3(x, y, 0.0f));
+				m_Particles.inverseMass[id] = (i == divisor) ? 0.0f : 1.0f;
+				m_TexCoords[id] = glm::vec2((x + halfSize) / size, (y + halfSize) / size);
 			}
 		}
 
-		// The size of particles is (divisor + 1) * (divisor + 1)
-		for (int i = 0; i < divisor; i++)
+		m_Indices.clear();
+
+		for (uint32_t i = 0; i < divisor; i++)
 		{
-			for (int j = 0; j < divisor; j++)
+			for (uint32_t j = 0; j < divisor; j++)
 			{
 				// 1st triangle
 				//        3
 				//      / |
 				//     /  |
 				//   1 -- 2
-				m_Indices.push_back(i * (divisor + 1) + j);
-				m_Indices.push_back(i * (divisor + 1) + j + 1);
-				m_Indices.push_back((i + 1) * (divisor + 1) + j + 1);
+				m_Indices.push_back(i * side + j);
+				m_Indices.push_back(i * side + j + 1);
+				m_Indices.push_back((i + 1) * side + j + 1);
 
 				// 2nd triangle
 				//  3 -- 2
 				//  |  / 
 				//  | /  
 				//  1 
-				m_Indices.push_back(i * (divisor + 1) + j);
-				m_Indices.push_back((i + 1) * (divisor + 1) + j + 1);
-				m_Indices.push_back((i + 1) * (divisor + 1) + j);
-
-				// Constraints
-				//  2 --- 3
-				//  |     |
-				//  |     |
-				//  1 --- 4
-				int index1 = i * (divisor + 1) + j;
-				int index2 = (i + 1) * (divisor + 1) + j;
-				int index3 = (i + 1) * (divisor + 1) + j + 1;
-				int index4 = i * (divisor + 1) + j + 1;
-
-				ClothParticle* p1 = &m_ClothParticles[index1];
-				ClothParticle* p2 = &m_ClothParticles[index2];
-				ClothParticle* p3 = &m_ClothParticles[index3];
-				ClothParticle* p4 = &m_ClothParticles[index4];
-
-				m_Constraints.push_back(ClothConstraint(p1, p2));
-				m_Constraints.push_back(ClothConstraint(p1, p4));
-				m_Constraints.push_back(ClothConstraint(p2, p3));
-				m_Constraints.push_back(ClothConstraint(p3, p4));
+				m_Indices.push_back(i * side + j);
+				m_Indices.push_back((i + 1) * side + j + 1);
+				m_Indices.push_back((i + 1) * side + j);
+			}
+		}
 
+		BuildConstraints();
+
+		// Particle to face rows, counted then filled
+		uint32_t faceCount = m_Indices.size() / 3;
+
+		m_ParticleFaceOffsets.assign(particleCount + 1, 0);
+		for (uint32_t index : m_Indices)
+			m_ParticleFaceOffsets[index + 1]++;
+
+		for (uint32_t i = 0; i < particleCount; i++)
+			m_ParticleFaceOffsets[i + 1] += m_ParticleFaceOffsets[i];
+
+		std::vector<uint32_t> next(m_ParticleFaceOffsets.begin(), m_ParticleFaceOffsets.end() - 1);
+		m_ParticleFaces.resize(m_Indices.size());
+		for (uint32_t i = 0; i < m_Indices.size(); i++)
+			m_ParticleFaces[next[m_Indices[i]]++] = i / 3;
+
+		m_FaceWind.assign(faceCount, glm::vec3(0.0f));
+		m_FaceNormals.assign(faceCount, glm::vec3(0.0f, 0.0f, 1.0f));
+	}
+
+	void Cloth::BuildConstraints()
+	{
+		uint32_t side = m_Side;
+		float diagonal = m_Spacing * std::sqrt(2.0f);
+
+		m_Constraints.Clear();
+
+		for (uint32_t i = 0; i < side; i++)
+		{
+			for (uint32_t j = 0; j < side; j++)
+			{
+				uint32_t id = i * side + j;
+
+				// Every grid edge once
+				if (j + 1 < side)
+					m_Constraints.Add(id, id + 1, m_Spacing, ClothConstraintType::STRUCTURAL);
+				if (i + 1 < side)
+					m_Constraints.Add(id, id + side, m_Spacing, ClothConstraintType::STRUCTURAL);
+
+				// Both diagonals of the cell above and to the right
+				if (m_Settings.shear && i + 1 < side && j + 1 < side)
+				{
+					m_Constraints.Add(id, id + side + 1, diagonal, ClothConstraintType::SHEAR);
+					m_Constraints.Add(id + 1, id + side, diagonal, ClothConstraintType::SHEAR);
+				}
+
+				// Skipping one particle resists folding along the rows
+				// and columns
+				if (m_Settings.bending && j + 2 < side)
+					m_Constraints.Add(id, id + 2, 2.0f * m_Spacing, ClothConstraintType::BENDING);
+				if (m_Settings.bending && i + 2 < side)
+					m_Constraints.Add(id, id + 2 * side, 2.0f * m_Spacing, ClothConstraintType::BENDING);
 			}
 		}
+
+		m_Constraints.Color(side * side);
+		UpdateCompliance();
+
+		GP_TRACE("Cloth has {0} particles and {1} constraints in {2} colors", side * side,
+			m_Constraints.GetCount(), m_Constraints.GetColorCount());
+	}
+
+	void Cloth::UpdateCompliance()
+	{
+		m_Constraints.SetCompliance(ClothConstraintType::STRUCTURAL, m_Settings.structuralCompliance);
+		m_Constraints.SetCompliance(ClothConstraintType::SHEAR, m_Settings.shearCompliance);
+		m_Constraints.SetCompliance(ClothConstraintType::BENDING, m_Settings.bendingCompliance);
 	}
 
-	void Cloth::ApplyForceToTriangle(ClothParticle* p1,
-		ClothParticle* p2,
-		ClothParticle* p3,
-		const glm::vec3& direction)
+	void Cloth::SetSettings(const ClothSettings& settings)
 	{
-		glm::vec3 normal = ComputeFaceNormal(p1->pos, p2->pos, p3->pos);
-		glm::vec3 normalDir = glm::normalize(normal);
-		glm::vec3 force = normal * (glm::dot(normalDir, direction));
-		p1->addForce(force);
-		p2->addForce(force);
-		p3->addForce(force);
+		bool rebuild = settings.shear != m_Settings.shear || settings.bending != m_Settings.bending;
+
+		m_Settings = settings;
+		m_Settings.substeps = std::max(1u, m_Settings.substeps);
+
+		if (rebuild)
+			BuildConstraints();
+		else
+			UpdateCompliance();
 	}
 
 	void Cloth::Step()
 	{
-		ApplyGravity();
-		ApplyWind(glm::vec3(0.0f, 0.0f, -4.0f * TIMESTEP));
+		Timer timer;
+
+		uint32_t substeps = std::max(1u, m_Settings.substeps);
+
+		VerletSpecs specs;
+		specs.timeStep = m_Settings.timeStep / substeps;
+		specs.gravity = m_Settings.gravity;
+		// Compounds back to the per step damping over the substeps
+		specs.damping = 1.0f - std::pow(1.0f - m_Settings.damping, 1.0f / substeps);
+
+		m_SelfCollisionStats = ClothSelfCollisionStats();
 
-		for (int i = 0; i < CONSTRAINT_ITERATIONS; i++)
+		// Wind is evaluated on the shape at the start of the step and
+		// kept for all of its substeps
+		ApplyWind(m_Settings.wind);
+
+		for (uint32_t substep = 0; substep < substeps; substep++)
 		{
-			for (auto& constraint : m_Constraints)
+			ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
+			{
+				m_Kernels->integrate(m_Particles, begin, end, specs);
+			});
+
+			if (m_Settings.solver == ClothSolver::XPBD)
 			{
-				constraint.apply();
+				ParallelFor(m_Constraints.GetCount(), [&](uint32_t begin, uint32_t end)
+				{
+					m_Constraints.ResetMultipliers(begin, end);
+				});
+			}
+
+			for (uint32_t i = 0; i < m_Settings.iterations; i++)
+				ProjectConstraints(specs.timeStep);
+
+			if (m_Settings.selfCollision)
+				SelfCollide();
+
+			if (m_Collider)
+			{
+				ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
+				{
+					m_Collider->Collide(m_Particles, begin, end, m_Settings.collisionThickness, m_Settings.friction);
+				});
 			}
 		}
 
-		for (auto& particle : m_ClothParticles)
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
 		{
-			particle.step();
-		}
+			std::fill(m_Particles.accelerationX.begin() + begin, m_Particles.accelerationX.begin() + end, 0.0f);
+			std::fill(m_Particles.accelerationY.begin() + begin, m_Particles.accelerationY.begin() + end, 0.0f);
+			std::fill(m_Particles.accelerationZ.begin() + begin, m_Particles.accelerationZ.begin() + end, 0.0f);
+		});
 
 		UpdateNormals();
 		UpdateVertexBuffer();
+
+		m_StepTime = timer.ElapsedMilliseconds();
+	}
+
+	void Cloth::ProjectConstraints(float timeStep)
+	{
+		bool xpbd = m_Settings.solver == ClothSolver::XPBD;
+
+		// Colors run one after another, the constraints inside a color
+		// touch different particles and are split over the threads
+		for (uint32_t color = 0; color < m_Constraints.GetColorCount(); color++)
+		{
+			uint32_t begin = m_Constraints.GetColorBegin(color);
+			uint32_t end = m_Constraints.GetColorEnd(color);
+
+			// Lanes of the serial batch may share particles, it gets
+			// the scalar kernels
+			const ClothKernels* kernels = m_Constraints.IsSerialColor(color) ? &ClothKernels::Get(SimdLevel::SCALAR) : m_Kernels;
+
+			auto project = [&](uint32_t first, uint32_t last)
+			{
+				if (xpbd)
+					kernels->projectConstraintsXPBD(m_Particles, m_Constraints, begin + first, begin + last, timeStep);
+				else
+					kernels->projectConstraints(m_Particles, m_Constraints, begin + first, begin + last);
+			};
+
+			if (m_Constraints.IsSerialColor(color))
+				project(0, end - begin);
+			else
+				ParallelFor(end - begin, project);
+		}
 	}
 
+	void Cloth::SelfCollide()
+	{
+		float distance = m_Settings.selfCollisionDistance * m_Spacing;
+		if (distance <= 0.0f)
+			return;
+
+		// Queries reach half a cell
+		m_SpatialHash.Build(m_Particles, 2.0f * distance);
+		m_SelfCollisionStats.hashBuildTime += m_SpatialHash.GetBuildTime();
+
+		Timer timer;
+
+		m_SelfCollisionCorrections.resize(m_Particles.GetCount());
+		std::atomic<uint32_t> contactCount(0);
+
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
+		{
+			uint32_t contacts = 0;
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				glm::vec3 correction(0.0f);
+				float wi = m_Particles.inverseMass[i];
+
+				if (wi > 0.0f)
+				{
+					glm::vec3 position = m_Particles.GetPosition(i);
+					int row = i / m_Side;
+					int column = i % m_Side;
+
+					m_SpatialHash.Query(position, [&](uint32_t j)
+					{
+						if (j == i)
+							return;
+
+						glm::vec3 offset = position - m_Particles.GetPosition(j);
+						float squared = glm::dot(offset, offset);
+						if (squared >= distance * distance || squared == 0.0f)
+							return;
+
+						// Grid neighbors may come closer than distance
+						// but not closer than they are at rest
+						int rowOffset = (int)(j / m_Side) - row;
+						int columnOffset = (int)(j % m_Side) - column;
+						float rest = m_Spacing * std::sqrt((float)(rowOffset * rowOffset + columnOffset * columnOffset));
+						float minDistance = std::min(distance, rest);
+						if (squared >= minDistance * minDistance)
+							return;
+
+						// This particle's share of the separation, its
+						// neighbor takes the rest when it gathers
+						float current = std::sqrt(squared);
+						float share = wi / (wi + m_Particles.inverseMass[j]);
+						correction += offset / current * (minDistance - current) * share;
+
+						// Pinned particles gather nothing, the other
+						// side counts those pairs
+						if (j > i || m_Particles.inverseMass[j] == 0.0f)
+							contacts++;
+					});
+				}
+
+				m_SelfCollisionCorrections[i] = correction;
+			}
+
+			contactCount += contacts;
+		});
+
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				m_Particles.SetPosition(i, m_Particles.GetPosition(i) + m_SelfCollisionCorrections[i]);
+		});
+
+		m_SelfCollisionStats.contactCount += contactCount;
+		m_SelfCollisionStats.queryTime += timer.ElapsedMilliseconds();
+	}
 
 	void Cloth::SphereCollision(glm::mat4 sphereTransform, float radius)
 	{
@@ -156,82 +348,115 @@ namespace GP
 
 		glm::vec3 center = translation;
 
-		for (auto& particle : m_ClothParticles)
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
 		{
-			glm::vec3 v = particle.pos - center;
-			float dist = glm::length(v);
-
-			if (dist < r)
+			for (uint32_t i = begin; i < end; i++)
 			{
-				particle.offsetPosition(glm::normalize(v) * (r - dist) * 1.4f);
+				if (m_Particles.inverseMass[i] == 0.0f)
+					continue;
+
+				glm::vec3 position = m_Particles.GetPosition(i);
+				glm::vec3 v = position - center;
+				float dist = glm::length(v);
+
+				if (dist < r && dist > 0.0f)
+					m_Particles.SetPosition(i, position + v / dist * (r - dist) * 1.4f);
 			}
-		}
+		});
 	}
 
-
 	void Cloth::UpdateNormals()
 	{
-		for (auto& particle : m_ClothParticles)
+		ParallelFor(m_FaceNormals.size(), [&](uint32_t begin, uint32_t end)
 		{
-			particle.resetNormal();
-		}
+			for (uint32_t f = begin; f < end; f++)
+			{
+				m_FaceNormals[f] = ComputeFaceNormal(m_Particles.GetPosition(m_Indices[f * 3]),
+					m_Particles.GetPosition(m_Indices[f * 3 + 1]),
+					m_Particles.GetPosition(m_Indices[f * 3 + 2]));
+			}
+		});
 
-		for (int i = 0; i < m_Indices.size(); i += 3)
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
 		{
-			ClothParticle* p1 = &m_ClothParticles[m_Indices[i]];
-			ClothParticle* p2 = &m_ClothParticles[m_Indices[i + 1]];
-			ClothParticle* p3 = &m_ClothParticles[m_Indices[i + 2]];
-
-			glm::vec3 norm = ComputeFaceNormal(p1->pos, p2->pos, p3->pos);
-
-			p1->addNormal(norm);
-			p2->addNormal(norm);
-			p3->addNormal(norm);
-		}
+			for (uint32_t i = begin; i < end; i++)
+			{
+				glm::vec3 normal(0.0f);
+				for (uint32_t f = m_ParticleFaceOffsets[i]; f < m_ParticleFaceOffsets[i + 1]; f++)
+					normal += m_FaceNormals[m_ParticleFaces[f]];
 
-		for (auto& particle : m_ClothParticles)
-		{
-			particle.normal = glm::normalize(particle.normal);
-		}
+				float length = glm::length(normal);
+				m_Normals[i] = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+			}
+		});
 	}
 
 	void Cloth::UpdateVertexBuffer()
 	{
-		for (int i = 0; i < m_ArrayBuffer.size(); i++)
+		// Written straight into the mapped buffer from every thread, a
+		// failed mapping falls back to a staging copy
+		ClothVertex* vertices = (ClothVertex*)m_VertexBuffer->Map();
+		bool mapped = vertices != nullptr;
+
+		std::vector<ClothVertex> staging;
+		if (!mapped)
 		{
-			m_ArrayBuffer[i].Normal = m_ClothParticles[i].normal;
-			m_ArrayBuffer[i].Pos = m_ClothParticles[i].pos;
+			GP_WARN("Could not map the cloth vertex buffer, uploading through a copy");
+			staging.resize(m_Particles.GetCount());
+			vertices = staging.data();
 		}
 
-		m_VertexArray->Bind();
-		m_VertexBuffer->SetData(&m_ArrayBuffer[0], m_ArrayBuffer.size() * sizeof(ClothVertex));
-	}
-
-	void Cloth::ApplyGravity()
-	{
-		for (auto& particle : m_ClothParticles)
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
 		{
-			particle.addForce(glm::vec3(0.0f, -9.8f * particle.mass * TIMESTEP, 0.0f));
-		}
+			for (uint32_t i = begin; i < end; i++)
+			{
+				vertices[i].Pos = m_Particles.GetPosition(i);
+				vertices[i].Normal = m_Normals[i];
+				vertices[i].TexCoord = m_TexCoords[i];
+			}
+		});
+
+		if (mapped)
+			m_VertexBuffer->Unmap();
+		else
+			m_VertexBuffer->SetData(staging.data(), (uint32_t)(staging.size() * sizeof(ClothVertex)));
 	}
 
 	void Cloth::ApplyWind(const glm::vec3& direction)
 	{
-		for (int i = 0; i < m_Indices.size(); i += 3)
+		ParallelFor(m_FaceWind.size(), [&](uint32_t begin, uint32_t end)
 		{
-			ClothParticle* p1 = &m_ClothParticles[m_Indices[i]];
-			ClothParticle* p2 = &m_ClothParticles[m_Indices[i + 1]];
-			ClothParticle* p3 = &m_ClothParticles[m_Indices[i + 2]];
+			for (uint32_t f = begin; f < end; f++)
+			{
+				glm::vec3 normal = ComputeFaceNormal(m_Particles.GetPosition(m_Indices[f * 3]),
+					m_Particles.GetPosition(m_Indices[f * 3 + 1]),
+					m_Particles.GetPosition(m_Indices[f * 3 + 2]));
 
-			ApplyForceToTriangle(p1, p2, p3, direction);
-		}
+				m_FaceWind[f] = normal * glm::dot(normal, direction);
+			}
+		});
+
+		ParallelFor(m_Particles.GetCount(), [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				glm::vec3 wind(0.0f);
+				for (uint32_t f = m_ParticleFaceOffsets[i]; f < m_ParticleFaceOffsets[i + 1]; f++)
+					wind += m_FaceWind[m_ParticleFaces[f]];
+
+				float w = m_Particles.inverseMass[i];
+				m_Particles.accelerationX[i] += wind.x * w;
+				m_Particles.accelerationY[i] += wind.y * w;
+				m_Particles.accelerationZ[i] += wind.z * w;
+			}
+		});
 	}
+
 	void Cloth::SetupMesh()
 	{
 		m_VertexArray = VertexArray::Create();
 
-		m_VertexBuffer = VertexBuffer::CreateDynamic(m_ArrayBuffer.size() * sizeof(ClothVertex));
-		m_VertexBuffer->SetData(&m_ArrayBuffer[0], m_ArrayBuffer.size() * sizeof(ClothVertex));
+		m_VertexBuffer = VertexBuffer::CreateDynamic(m_Particles.GetCount() * sizeof(ClothVertex));
 		m_VertexBuffer->SetLayout(
 			{
 				{ ShaderDataType::Float3, "a_Position" },
@@ -240,16 +465,13 @@ namespace GP
 			}
 		);
 
+		UpdateVertexBuffer();
+
 		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
 		m_IndexBuffer = IndexBuffer::Create(&m_Indices[0], m_Indices.size());
 		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
 	}
 
-	void Cloth::AddIndices(uint32_t i1, uint32_t i2, uint32_t i3)
-	{
-	}
-
-
 	void Cloth::Draw(Ref<Shader> mainShader,
 		Ref<Shader> colorShader,
 		Ref<Shader> singleColorShader,
@@ -14,116 +14,111 @@
 
 #include <MeshOperations/EditorMesh.h>
 
-
-#define DAMPING 0.01
-#define TIMESTEP 0.5 * 0.5 * 0.025
-#define CONSTRAINT_ITERATIONS 3
+#include <Cloth/ClothParticles.h>
+#include <Cloth/ClothConstraints.h>
+#include <Cloth/ClothKernels.h>
+#include <Cloth/ClothCollider.h>
+#include <Cloth/ClothSpatialHash.h>
 
 namespace GP
 {
-	struct ClothParticle
+	struct ClothVertex
 	{
-		bool moving;
-		uint32_t id;
-		float mass;
-		glm::vec3 acceleration;
-		glm::vec3 pos;
-		glm::vec3 oldPos;
-		glm::vec3 normal;
-
-
-		void addForce(glm::vec3 f)
-		{
-			acceleration += f / mass;
-		}
-
-		void step()
-		{
-			if (moving)
-			{
-				glm::vec3 temp = pos;
-				pos = pos + (pos - oldPos) * (float)(1.0 - DAMPING) + acceleration * (float)(TIMESTEP);
-				oldPos = temp;
-				acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
-			}
-		}
-
-		void resetAcceleration() { acceleration = glm::vec3(0.0f, 0.0f, 0.0f); }
-		void offsetPosition(glm::vec3 offset) { if (moving) pos += offset; }
-		void disableMoving() { moving = false; }
-
-		void addNormal(glm::vec3 n)
-		{
-			normal += glm::normalize(n);
-		}
-
-		void resetNormal() { normal = glm::vec3(0.0f, 0.0f, 0.0f); }
+		glm::vec3 Pos;
+		glm::vec3 Normal;
+		glm::vec2 TexCoord;
+	};
 
+	enum class ClothSolver
+	{
+		// Every constraint is fully projected, the cloth gets stiffer
+		// with more iterations
+		PBD = 0,
+		// Compliant constraints, stiffness stays the same for any
+		// iteration and substep count
+		XPBD = 1
 	};
 
-	struct ClothConstraint
+	struct ClothSettings
 	{
-		float restDistance;
-		ClothParticle* particle1;
-		ClothParticle* particle2;
-
-		ClothConstraint(ClothParticle* p1, ClothParticle* p2)
-		{
-			particle1 = p1;
-			particle2 = p2;
-			restDistance = glm::length(p1->pos - p2->pos);
-		}
-
-		void apply()
-		{
-			glm::vec3 p1p2 = particle2->pos - particle1->pos;
-			float dist = glm::length(p1p2);
-			glm::vec3 correction = p1p2 * (1 - restDistance / dist);
-			glm::vec3 correctionHalf = correction / 2.0f;
-			particle1->offsetPosition(correctionHalf);
-			particle2->offsetPosition(-correctionHalf);
-		}
+		ClothSolver solver = ClothSolver::XPBD;
+
+		// One Step() advances timeStep, split into substeps. Substeps
+		// converge better than iterations for the same cost, each one
+		// integrates once and projects the constraints iterations times
+		float timeStep = 0.00625f;
+		uint32_t substeps = 1;
+		uint32_t iterations = 3;
+
+		// Fraction of the velocity lost per step, independent of substeps
+		float damping = 0.01f;
+
+		glm::vec3 gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+		glm::vec3 wind = glm::vec3(0.0f, 0.0f, -4.0f);
+
+		// Opt-in, together they triple the constraint count. Changing
+		// these rebuilds the constraints
+		bool shear = false;
+		bool bending = false;
+
+		// Inverse stiffness of each constraint type, XPBD only
+		float structuralCompliance = 0.0f;
+		float shearCompliance = 0.000001f;
+		float bendingCompliance = 0.0001f;
+
+		// Distance kept from the collider surface and the fraction of
+		// sliding removed while touching it
+		float collisionThickness = 0.02f;
+		float friction = 0.3f;
+
+		// Keeps particles this many grid spacings apart, pairs closer
+		// at rest only keep their rest distance
+		bool selfCollision = false;
+		float selfCollisionDistance = 0.8f;
 	};
 
-	struct ClothVertex
+	// Summed over the substeps of the last step
+	struct ClothSelfCollisionStats
 	{
-		glm::vec3 Pos;
-		glm::vec3 Normal;
-		glm::vec2 TexCoord;
+		float hashBuildTime = 0.0f;
+		float queryTime = 0.0f;
+		uint32_t contactCount = 0;
 	};
 
 
 
 	// Original Cloth will always
-	// be square shaped
+	// be square shaped. Particles are kept as structure of arrays and
+	// constraints as colored index lists, every pass of a step runs over
+	// particles, faces or one constraint color at a time on all cores.
 	class Cloth
 	{
 	public:
-		Cloth(uint32_t size, uint32_t divisor);
+		Cloth(uint32_t size, uint32_t divisor, const ClothSettings& settings = ClothSettings());
 
 		void BuildVertices() {}
 
-		static Ref<Cloth> Create(uint32_t size, uint32_t divisor);
+		static Ref<Cloth> Create(uint32_t size, uint32_t divisor, const ClothSettings& settings = ClothSettings());
 
 		void InitializeArrayBuffer(uint32_t size, uint32_t divisor);
 		void SetupMesh();
 
-		void AddIndices(uint32_t i1, uint32_t i2, uint32_t i3);
-
-		void ApplyForceToTriangle(ClothParticle* p1,
-			ClothParticle* p2,
-			ClothParticle* p3,
-			const glm::vec3& direction);
-
-		void ApplyGravity();
-
+		// Wind force of every face, gathered into the acceleration of its
+		// particles
 		void ApplyWind(const glm::vec3& direction);
 
 		void Step();
 
+		const ClothSettings& GetSettings() const { return m_Settings; }
+		void SetSettings(const ClothSettings& settings);
+
 
 		void SphereCollision(glm::mat4 sphereTransform, float radius);
 
+		// Resolved after the constraints of every substep, null disables
+		void SetCollider(const Ref<ClothCollider>& collider) { m_Collider = collider; }
+		const Ref<ClothCollider>& GetCollider() const { return m_Collider; }
+
 		void UpdateNormals();
 		
 		void UpdateVertexBuffer();
@@ -133,22 +128,67 @@ namespace GP
 			Ref<Shader> singleColorShader,
 			Ref<EnvironmentMap> envMap,
 			uint32_t ditheringTex) const;
+
+		uint32_t GetParticleCount() const { return m_Particles.GetCount(); }
+		const ClothParticles& GetParticles() const { return m_Particles; }
+		const ClothConstraints& GetConstraints() const { return m_Constraints; }
+
+		float GetStepTime() const { return m_StepTime; }
+		const ClothSelfCollisionStats& GetSelfCollisionStats() const { return m_SelfCollisionStats; }
 	public:
 		RenderSpecs m_RenderSpecs;
 	protected:
-		glm::vec3 ComputeFaceNormal(const glm::vec3& v1,
+		static glm::vec3 ComputeFaceNormal(const glm::vec3& v1,
 			const glm::vec3& v2,
 			const glm::vec3& v3);
 
-		std::vector<ClothVertex> m_ArrayBuffer;
-		std::vector<ClothParticle> m_ClothParticles;
-		std::vector<ClothConstraint> m_Constraints;
+		// Structural, shear and bending constraints of the enabled
+		// types, colored into parallel batches
+		void BuildConstraints();
+		void UpdateCompliance();
+
+		void ProjectConstraints(float timeStep);
+
+		// Every particle gathers its pushes from the hashed neighbors,
+		// then all of them are applied, so no two threads write one
+		// particle
+		void SelfCollide();
+
+		ClothSettings m_Settings;
+
+		ClothParticles m_Particles;
+		ClothConstraints m_Constraints;
+		Ref<ClothCollider> m_Collider;
+
+		ClothSpatialHash m_SpatialHash;
+		std::vector<glm::vec3> m_SelfCollisionCorrections;
+		ClothSelfCollisionStats m_SelfCollisionStats;
+
+		// Grid the constraints are built on
+		uint32_t m_Side = 0;
+		float m_Spacing = 0.0f;
+
+		std::vector<glm::vec3> m_Normals;
+		std::vector<glm::vec2> m_TexCoords;
+
+		// Faces around each particle in compressed rows, particles gather
+		// face values instead of faces scattering into shared particles
+		std::vector<uint32_t> m_ParticleFaceOffsets;
+		std::vector<uint32_t> m_ParticleFaces;
+
+		std::vector<glm::vec3> m_FaceWind;
+		std::vector<glm::vec3> m_FaceNormals;
 
 		std::vector<uint32_t> m_Indices;
 
+		// Widest instruction set of the CPU, picked once
+		const ClothKernels* m_Kernels = nullptr;
+
+		float m_StepTime = 0.0f;
+
 		Ref<VertexArray> m_VertexArray;
 		Ref<VertexBuffer> m_VertexBuffer;
 		Ref<IndexBuffer> m_IndexBuffer;
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,378 @@
+#include <Precomp.h>
+#include <Cloth/ClothCollider.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+
+namespace GP
+{
+	static const uint32_t MAX_LEAF_TRIANGLES = 4;
+
+	// Deeper than any median split tree gets
+	static const uint32_t MAX_STACK_SIZE = 64;
+
+	ClothCollider::ClothCollider(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Timer timer;
+
+		m_LocalVertices = vertices;
+		m_Vertices = vertices;
+
+		uint32_t triangleCount = indices.size() / 3;
+
+		std::vector<glm::uvec3> triangles(triangleCount);
+		std::vector<glm::vec3> centroids(triangleCount);
+		std::vector<uint32_t> order(triangleCount);
+
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			triangles[i] = glm::uvec3(indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]);
+			centroids[i] = (vertices[triangles[i].x] + vertices[triangles[i].y] + vertices[triangles[i].z]) / 3.0f;
+			order[i] = i;
+		}
+
+		m_Nodes.clear();
+		m_Nodes.reserve(2 * triangleCount / MAX_LEAF_TRIANGLES + 1);
+
+		if (triangleCount > 0)
+			Build(0, triangleCount, order, centroids);
+
+		m_Triangles.resize(triangleCount);
+		for (uint32_t i = 0; i < triangleCount; i++)
+			m_Triangles[i] = triangles[order[i]];
+
+		Refit();
+
+		GP_TRACE("Cloth collider BVH of {0} triangles in {1} nodes built in {2} ms", triangleCount, m_Nodes.size(), timer.ElapsedMilliseconds());
+	}
+
+	Ref<ClothCollider> ClothCollider::Create(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+	{
+		return std::make_shared<ClothCollider>(vertices, indices);
+	}
+
+	uint32_t ClothCollider::Build(uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<glm::vec3>& centroids)
+	{
+		uint32_t index = m_Nodes.size();
+		m_Nodes.push_back(Node());
+
+		if (end - begin <= MAX_LEAF_TRIANGLES)
+		{
+			m_Nodes[index].first = begin;
+			m_Nodes[index].count = end - begin;
+			return index;
+		}
+
+		glm::vec3 centroidMin(std::numeric_limits<float>::max());
+		glm::vec3 centroidMax(-std::numeric_limits<float>::max());
+		for (uint32_t i = begin; i < end; i++)
+		{
+			centroidMin = glm::min(centroidMin, centroids[order[i]]);
+			centroidMax = glm::max(centroidMax, centroids[order[i]]);
+		}
+
+		glm::vec3 extent = centroidMax - centroidMin;
+		int axis = 0;
+		if (extent.y > extent[axis])
+			axis = 1;
+		if (extent.z > extent[axis])
+			axis = 2;
+
+		// Halving the count keeps the depth logarithmic whatever the
+		// triangles look like
+		uint32_t middle = (begin + end) / 2;
+		std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+			[&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+		Build(begin, middle, order, centroids);
+		uint32_t right = Build(middle, end, order, centroids);
+
+		m_Nodes[index].first = right;
+		m_Nodes[index].count = 0;
+
+		return index;
+	}
+
+	void ClothCollider::Refit()
+	{
+		// Children always come after their parent
+		for (int i = (int)m_Nodes.size() - 1; i >= 0; i--)
+		{
+			Node& node = m_Nodes[i];
+
+			if (node.count > 0)
+			{
+				node.min = glm::vec3(std::numeric_limits<float>::max());
+				node.max = glm::vec3(-std::numeric_limits<float>::max());
+				for (uint32_t t = node.first; t < node.first + node.count; t++)
+				{
+					for (int corner = 0; corner < 3; corner++)
+					{
+						node.min = glm::min(node.min, m_Vertices[m_Triangles[t][corner]]);
+						node.max = glm::max(node.max, m_Vertices[m_Triangles[t][corner]]);
+					}
+				}
+			}
+			else
+			{
+				const Node& left = m_Nodes[i + 1];
+				const Node& right = m_Nodes[node.first];
+				node.min = glm::min(left.min, right.min);
+				node.max = glm::max(left.max, right.max);
+			}
+		}
+	}
+
+	void ClothCollider::SetTransform(const glm::mat4& transform)
+	{
+		if (transform == m_Transform)
+			return;
+
+		m_Transform = transform;
+
+		for (uint32_t i = 0; i < m_LocalVertices.size(); i++)
+			m_Vertices[i] = glm::vec3(transform * glm::vec4(m_LocalVertices[i], 1.0f));
+
+		Refit();
+	}
+
+	glm::vec3 ClothCollider::GetNormal(uint32_t triangle) const
+	{
+		const glm::uvec3& t = m_Triangles[triangle];
+		glm::vec3 normal = glm::cross(m_Vertices[t.y] - m_Vertices[t.x], m_Vertices[t.z] - m_Vertices[t.x]);
+
+		float length = glm::length(normal);
+		return length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+
+	bool ClothCollider::Sweep(const glm::vec3& start, const glm::vec3& end, float& t, uint32_t& triangle) const
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		glm::vec3 direction = end - start;
+
+		// A zero component would give 0 * inf = NaN in the slab test for
+		// points on a slab plane, a tiny signed one keeps the test exact
+		// for segments parallel to the plane
+		glm::vec3 slabDirection = direction;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (std::abs(slabDirection[axis]) < 1e-20f)
+				slabDirection[axis] = std::copysign(1e-20f, slabDirection[axis]);
+		}
+
+		glm::vec3 inverseDirection = 1.0f / slabDirection;
+
+		float closest = 1.0f;
+		bool hit = false;
+
+		uint32_t stack[MAX_STACK_SIZE];
+		uint32_t top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const Node& node = m_Nodes[stack[--top]];
+
+			// Slab test against the part of the segment before the
+			// closest hit so far
+			glm::vec3 t1 = (node.min - start) * inverseDirection;
+			glm::vec3 t2 = (node.max - start) * inverseDirection;
+			glm::vec3 lower = glm::min(t1, t2);
+			glm::vec3 upper = glm::max(t1, t2);
+
+			float enter = std::max(std::max(lower.x, lower.y), std::max(lower.z, 0.0f));
+			float exit = std::min(std::min(upper.x, upper.y), std::min(upper.z, closest));
+			if (enter > exit)
+				continue;
+
+			if (node.count == 0)
+			{
+				stack[top++] = node.first;
+				stack[top++] = (uint32_t)(&node - m_Nodes.data()) + 1;
+				continue;
+			}
+
+			// Moller-Trumbore, both sides of the triangles count
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				const glm::vec3& a = m_Vertices[m_Triangles[i].x];
+				glm::vec3 e1 = m_Vertices[m_Triangles[i].y] - a;
+				glm::vec3 e2 = m_Vertices[m_Triangles[i].z] - a;
+
+				glm::vec3 p = glm::cross(direction, e2);
+				float determinant = glm::dot(e1, p);
+				if (std::abs(determinant) < 1e-12f)
+					continue;
+
+				float inverseDeterminant = 1.0f / determinant;
+				glm::vec3 s = start - a;
+
+				float u = glm::dot(s, p) * inverseDeterminant;
+				if (u < 0.0f || u > 1.0f)
+					continue;
+
+				glm::vec3 q = glm::cross(s, e1);
+				float v = glm::dot(direction, q) * inverseDeterminant;
+				if (v < 0.0f || u + v > 1.0f)
+					continue;
+
+				float hitT = glm::dot(e2, q) * inverseDeterminant;
+				if (hitT >= 0.0f && hitT < closest)
+				{
+					closest = hitT;
+					triangle = i;
+					hit = true;
+				}
+			}
+		}
+
+		t = closest;
+		return hit;
+	}
+
+	// Ericson, Real-Time Collision Detection 5.1.5
+	static glm::vec3 ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+	{
+		glm::vec3 ab = b - a;
+		glm::vec3 ac = c - a;
+		glm::vec3 ap = p - a;
+
+		float d1 = glm::dot(ab, ap);
+		float d2 = glm::dot(ac, ap);
+		if (d1 <= 0.0f && d2 <= 0.0f)
+			return a;
+
+		glm::vec3 bp = p - b;
+		float d3 = glm::dot(ab, bp);
+		float d4 = glm::dot(ac, bp);
+		if (d3 >= 0.0f && d4 <= d3)
+			return b;
+
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+			return a + ab * (d1 / (d1 - d3));
+
+		glm::vec3 cp = p - c;
+		float d5 = glm::dot(ab, cp);
+		float d6 = glm::dot(ac, cp);
+		if (d6 >= 0.0f && d5 <= d6)
+			return c;
+
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+			return a + ac * (d2 / (d2 - d6));
+
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		float denominator = 1.0f / (va + vb + vc);
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+
+	bool ClothCollider::Closest(const glm::vec3& point, float radius, glm::vec3& closest, uint32_t& triangle) const
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		float best = radius * radius;
+		bool found = false;
+
+		uint32_t stack[MAX_STACK_SIZE];
+		uint32_t top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const Node& node = m_Nodes[stack[--top]];
+
+			glm::vec3 outside = glm::max(glm::max(node.min - point, point - node.max), glm::vec3(0.0f));
+			if (glm::dot(outside, outside) > best)
+				continue;
+
+			if (node.count == 0)
+			{
+				stack[top++] = node.first;
+				stack[top++] = (uint32_t)(&node - m_Nodes.data()) + 1;
+				continue;
+			}
+
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				glm::vec3 candidate = ClosestPointOnTriangle(point, m_Vertices[m_Triangles[i].x],
+					m_Vertices[m_Triangles[i].y], m_Vertices[m_Triangles[i].z]);
+
+				glm::vec3 offset = point - candidate;
+				float distance = glm::dot(offset, offset);
+				if (distance <= best)
+				{
+					best = distance;
+					closest = candidate;
+					triangle = i;
+					found = true;
+				}
+			}
+		}
+
+		return found;
+	}
+
+	void ClothCollider::Collide(ClothParticles& particles, uint32_t begin, uint32_t end, float thickness, float friction) const
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (particles.inverseMass[i] == 0.0f)
+				continue;
+
+			glm::vec3 old(particles.oldX[i], particles.oldY[i], particles.oldZ[i]);
+			glm::vec3 position = particles.GetPosition(i);
+
+			bool contact = false;
+			glm::vec3 normal(0.0f);
+
+			// Stop at the first crossed triangle, on the side the
+			// particle came from
+			float t;
+			uint32_t triangle;
+			if (Sweep(old, position, t, triangle))
+			{
+				normal = GetNormal(triangle);
+				if (glm::dot(old - m_Vertices[m_Triangles[triangle].x], normal) < 0.0f)
+					normal = -normal;
+
+				position = old + (position - old) * t + normal * thickness;
+				contact = true;
+			}
+
+			glm::vec3 closest;
+			if (Closest(position, thickness, closest, triangle))
+			{
+				normal = GetNormal(triangle);
+				if (glm::dot(old - closest, normal) < 0.0f)
+					normal = -normal;
+
+				float depth = thickness - glm::dot(position - closest, normal);
+				if (depth > 0.0f)
+					position += normal * depth;
+
+				contact = true;
+			}
+
+			if (!contact)
+				continue;
+
+			// Verlet velocity is position - old, moving old removes the
+			// motion into the surface and part of the sliding
+			glm::vec3 velocity = position - old;
+			float normalSpeed = glm::dot(velocity, normal);
+			glm::vec3 tangential = velocity - normal * normalSpeed;
+			velocity = tangential * (1.0f - friction) + normal * std::max(normalSpeed, 0.0f);
+
+			particles.SetPosition(i, position);
+			particles.oldX[i] = position.x - velocity.x;
+			particles.oldY[i] = position.y - velocity.y;
+			particles.oldZ[i] = position.z - velocity.z;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GeoProcess/System/CoreSystem/Core.h>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Cloth/ClothParticles.h>
+
+namespace GP
+{
+	// Triangle mesh the cloth collides with. The triangles are kept in
+	// world space under a bounding volume hierarchy that is built once,
+	// when the transform changes the vertices are transformed and the
+	// boxes are refit bottom up instead of rebuilding the tree.
+	class ClothCollider
+	{
+	public:
+		ClothCollider(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+		static Ref<ClothCollider> Create(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+		// Does nothing when the transform did not change
+		void SetTransform(const glm::mat4& transform);
+		const glm::mat4& GetTransform() const { return m_Transform; }
+
+		// Keeps particles [begin, end) thickness away from the surface,
+		// on the side they came from. The path from the old position is
+		// swept first so fast particles can not tunnel through thin
+		// parts. Friction removes that fraction of the tangential motion
+		// of particles in contact
+		void Collide(ClothParticles& particles, uint32_t begin, uint32_t end, float thickness, float friction) const;
+
+		uint32_t GetTriangleCount() const { return (uint32_t)m_Triangles.size(); }
+		uint32_t GetNodeCount() const { return (uint32_t)m_Nodes.size(); }
+
+	private:
+		// Interior nodes have count 0, their left child follows them and
+		// first is the right child. Leaves hold triangles [first, first + count)
+		struct Node
+		{
+			glm::vec3 min;
+			uint32_t first;
+			glm::vec3 max;
+			uint32_t count;
+		};
+
+		// Median split of triangles [begin, end) of order along the
+		// longest axis of their centroids, returns the node index
+		uint32_t Build(uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<glm::vec3>& centroids);
+		void Refit();
+
+		// First triangle crossed by the segment from start to end, t is
+		// the fraction of the segment
+		bool Sweep(const glm::vec3& start, const glm::vec3& end, float& t, uint32_t& triangle) const;
+
+		// Closest surface point within radius
+		bool Closest(const glm::vec3& point, float radius, glm::vec3& closest, uint32_t& triangle) const;
+
+		glm::vec3 GetNormal(uint32_t triangle) const;
+
+	private:
+		std::vector<glm::vec3> m_LocalVertices;
+		std::vector<glm::vec3> m_Vertices;
+
+		// In leaf order
+		std::vector<glm::uvec3> m_Triangles;
+		std::vector<Node> m_Nodes;
+
+		glm::mat4 m_Transform = glm::mat4(1.0f);
+	};
+}
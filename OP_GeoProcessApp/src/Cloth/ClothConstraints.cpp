@@ -0,0 +1,116 @@
+#include <Precomp.h>
+#include <Cloth/ClothConstraints.h>
+
+namespace GP
+{
+	// One bit per color in a particle mask
+	static const uint32_t MAX_COLOR_COUNT = 64;
+
+	void ClothConstraints::Clear()
+	{
+		particle1.clear();
+		particle2.clear();
+		restDistance.clear();
+		compliance.clear();
+		lambda.clear();
+		type.clear();
+		m_ColorOffsets.clear();
+		m_HasSerialColor = false;
+	}
+
+	void ClothConstraints::Add(uint32_t p1, uint32_t p2, float rest, ClothConstraintType constraintType)
+	{
+		particle1.push_back(p1);
+		particle2.push_back(p2);
+		restDistance.push_back(rest);
+		compliance.push_back(0.0f);
+		lambda.push_back(0.0f);
+		type.push_back(constraintType);
+	}
+
+	void ClothConstraints::SetCompliance(ClothConstraintType constraintType, float value)
+	{
+		for (uint32_t i = 0; i < GetCount(); i++)
+		{
+			if (type[i] == constraintType)
+				compliance[i] = value;
+		}
+	}
+
+	void ClothConstraints::ResetMultipliers(uint32_t begin, uint32_t end)
+	{
+		std::fill(lambda.begin() + begin, lambda.begin() + end, 0.0f);
+	}
+
+	void ClothConstraints::Color(uint32_t particleCount)
+	{
+		uint32_t count = GetCount();
+
+		std::vector<uint64_t> usedColors(particleCount, 0);
+		std::vector<uint32_t> colors(count);
+		std::vector<uint32_t> colorSizes(MAX_COLOR_COUNT + 1, 0);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint64_t used = usedColors[particle1[i]] | usedColors[particle2[i]];
+
+			uint32_t color = MAX_COLOR_COUNT;
+			if (used != ~0ull)
+			{
+				color = 0;
+				while (used & (1ull << color))
+					color++;
+
+				usedColors[particle1[i]] |= 1ull << color;
+				usedColors[particle2[i]] |= 1ull << color;
+			}
+
+			colors[i] = color;
+			colorSizes[color]++;
+		}
+
+		m_HasSerialColor = colorSizes[MAX_COLOR_COUNT] > 0;
+
+		// Counting sort by color, constraints keep their order inside a batch
+		uint32_t colorCount = 0;
+		while (colorCount < MAX_COLOR_COUNT && colorSizes[colorCount] > 0)
+			colorCount++;
+
+		if (m_HasSerialColor)
+		{
+			colorSizes[colorCount] = colorSizes[MAX_COLOR_COUNT];
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (colors[i] == MAX_COLOR_COUNT)
+					colors[i] = colorCount;
+			}
+			colorCount++;
+		}
+
+		m_ColorOffsets.assign(colorCount + 1, 0);
+		for (uint32_t c = 0; c < colorCount; c++)
+			m_ColorOffsets[c + 1] = m_ColorOffsets[c] + colorSizes[c];
+
+		std::vector<uint32_t> next(m_ColorOffsets.begin(), m_ColorOffsets.end() - 1);
+		std::vector<uint32_t> sorted1(count), sorted2(count);
+		std::vector<float> sortedRest(count), sortedCompliance(count);
+		std::vector<ClothConstraintType> sortedType(count);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t slot = next[colors[i]]++;
+			sorted1[slot] = particle1[i];
+			sorted2[slot] = particle2[i];
+			sortedRest[slot] = restDistance[i];
+			sortedCompliance[slot] = compliance[i];
+			sortedType[slot] = type[i];
+		}
+
+		particle1.swap(sorted1);
+		particle2.swap(sorted2);
+		restDistance.swap(sortedRest);
+		compliance.swap(sortedCompliance);
+		type.swap(sortedType);
+		lambda.assign(count, 0.0f);
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+namespace GP
+{
+	enum class ClothConstraintType : uint8_t
+	{
+		// Grid edges
+		STRUCTURAL = 0,
+		// Both diagonals of every cell
+		SHEAR = 1,
+		// Particles two apart along rows and columns
+		BENDING = 2
+	};
+
+	// Index based distance constraints between two particles. After
+	// Color() the constraints are sorted into batches in which no two
+	// constraints share a particle, so one batch can be projected by any
+	// number of threads without locks while the batches still run one
+	// after another like Gauss-Seidel.
+	class ClothConstraints
+	{
+	public:
+		ClothConstraints() {}
+
+		void Clear();
+		void Add(uint32_t particle1, uint32_t particle2, float restDistance,
+			ClothConstraintType type = ClothConstraintType::STRUCTURAL);
+
+		// Inverse stiffness used by the XPBD kernels, zero is rigid
+		void SetCompliance(ClothConstraintType type, float compliance);
+
+		// XPBD accumulates a multiplier per constraint over the
+		// iterations of one substep, every substep starts from zero
+		void ResetMultipliers(uint32_t begin, uint32_t end);
+
+		// Greedy coloring, each constraint takes the lowest color neither
+		// of its particles uses yet. Constraints that find no free color
+		// end up in a last batch that is projected serially
+		void Color(uint32_t particleCount);
+
+		uint32_t GetCount() const { return (uint32_t)particle1.size(); }
+
+		uint32_t GetColorCount() const { return m_ColorOffsets.empty() ? 0 : (uint32_t)m_ColorOffsets.size() - 1; }
+		uint32_t GetColorBegin(uint32_t color) const { return m_ColorOffsets[color]; }
+		uint32_t GetColorEnd(uint32_t color) const { return m_ColorOffsets[color + 1]; }
+
+		// The serial batch, empty unless some particle has a very high degree
+		bool IsSerialColor(uint32_t color) const { return m_HasSerialColor && color + 1 == GetColorCount(); }
+
+	public:
+		std::vector<uint32_t> particle1;
+		std::vector<uint32_t> particle2;
+		std::vector<float> restDistance;
+		std::vector<float> compliance;
+		std::vector<float> lambda;
+		std::vector<ClothConstraintType> type;
+
+	private:
+		std::vector<uint32_t> m_ColorOffsets;
+		bool m_HasSerialColor = false;
+	};
+}
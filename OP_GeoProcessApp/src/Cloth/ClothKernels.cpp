@@ -0,0 +1,550 @@
+#include <Precomp.h>
+#include <Cloth/ClothKernels.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define GP_CLOTH_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		// MSVC compiles the intrinsics of any instruction set as they are
+		#define GP_TARGET_AVX2
+	#else
+		#define GP_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace GP
+{
+	// ************* SCALAR *************
+
+	static void IntegrateScalar(ClothParticles& p, uint32_t begin, uint32_t end, const VerletSpecs& specs)
+	{
+		const float damping = 1.0f - specs.damping;
+		const float dt2 = specs.timeStep * specs.timeStep;
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (p.inverseMass[i] == 0.0f)
+				continue;
+
+			float ax = p.accelerationX[i] + specs.gravity.x;
+			float ay = p.accelerationY[i] + specs.gravity.y;
+			float az = p.accelerationZ[i] + specs.gravity.z;
+
+			float x = p.x[i];
+			float y = p.y[i];
+			float z = p.z[i];
+
+			p.x[i] = x + (x - p.oldX[i]) * damping + ax * dt2;
+			p.y[i] = y + (y - p.oldY[i]) * damping + ay * dt2;
+			p.z[i] = z + (z - p.oldZ[i]) * damping + az * dt2;
+
+			p.oldX[i] = x;
+			p.oldY[i] = y;
+			p.oldZ[i] = z;
+		}
+	}
+
+	static void ProjectConstraintsScalar(ClothParticles& p, const ClothConstraints& c, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			uint32_t a = c.particle1[i];
+			uint32_t b = c.particle2[i];
+
+			float wa = p.inverseMass[a];
+			float wb = p.inverseMass[b];
+			float w = wa + wb;
+
+			float dx = p.x[b] - p.x[a];
+			float dy = p.y[b] - p.y[a];
+			float dz = p.z[b] - p.z[a];
+
+			float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+			if (w == 0.0f || dist == 0.0f)
+				continue;
+
+			// Split by inverse mass, a pinned particle does not move
+			float s = (1.0f - c.restDistance[i] / dist) / w;
+
+			p.x[a] += wa * s * dx;
+			p.y[a] += wa * s * dy;
+			p.z[a] += wa * s * dz;
+
+			p.x[b] -= wb * s * dx;
+			p.y[b] -= wb * s * dy;
+			p.z[b] -= wb * s * dz;
+		}
+	}
+
+	static void ProjectConstraintsXPBDScalar(ClothParticles& p, ClothConstraints& c, uint32_t begin, uint32_t end, float timeStep)
+	{
+		const float inverseDt2 = 1.0f / (timeStep * timeStep);
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			uint32_t a = c.particle1[i];
+			uint32_t b = c.particle2[i];
+
+			float wa = p.inverseMass[a];
+			float wb = p.inverseMass[b];
+
+			float alpha = c.compliance[i] * inverseDt2;
+			float w = wa + wb + alpha;
+
+			float dx = p.x[b] - p.x[a];
+			float dy = p.y[b] - p.y[a];
+			float dz = p.z[b] - p.z[a];
+
+			float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+			if (w == 0.0f || dist == 0.0f)
+				continue;
+
+			// Multiplier change, projected along the unit direction
+			float deltaLambda = (c.restDistance[i] - dist - alpha * c.lambda[i]) / w;
+			c.lambda[i] += deltaLambda;
+
+			float s = deltaLambda / dist;
+
+			p.x[a] -= wa * s * dx;
+			p.y[a] -= wa * s * dy;
+			p.z[a] -= wa * s * dz;
+
+			p.x[b] += wb * s * dx;
+			p.y[b] += wb * s * dy;
+			p.z[b] += wb * s * dz;
+		}
+	}
+
+#ifdef GP_CLOTH_X86
+
+	// ************* SSE *************
+
+	static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	static void IntegrateSSE(ClothParticles& p, uint32_t begin, uint32_t end, const VerletSpecs& specs)
+	{
+		const __m128 damping = _mm_set1_ps(1.0f - specs.damping);
+		const __m128 dt2 = _mm_set1_ps(specs.timeStep * specs.timeStep);
+		const __m128 zero = _mm_setzero_ps();
+
+		float* positions[3] = { p.x.data(), p.y.data(), p.z.data() };
+		float* oldPositions[3] = { p.oldX.data(), p.oldY.data(), p.oldZ.data() };
+		const float* accelerations[3] = { p.accelerationX.data(), p.accelerationY.data(), p.accelerationZ.data() };
+		const float gravity[3] = { specs.gravity.x, specs.gravity.y, specs.gravity.z };
+
+		uint32_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 moving = _mm_cmpneq_ps(_mm_loadu_ps(&p.inverseMass[i]), zero);
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				__m128 x = _mm_loadu_ps(positions[axis] + i);
+				__m128 old = _mm_loadu_ps(oldPositions[axis] + i);
+				__m128 a = _mm_add_ps(_mm_loadu_ps(accelerations[axis] + i), _mm_set1_ps(gravity[axis]));
+
+				__m128 next = _mm_add_ps(x, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(x, old), damping), _mm_mul_ps(a, dt2)));
+
+				_mm_storeu_ps(positions[axis] + i, Select(moving, next, x));
+				_mm_storeu_ps(oldPositions[axis] + i, Select(moving, x, old));
+			}
+		}
+
+		IntegrateScalar(p, i, end, specs);
+	}
+
+	static void ProjectConstraintsSSE(ClothParticles& p, const ClothConstraints& c, uint32_t begin, uint32_t end)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		uint32_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			const uint32_t* a = &c.particle1[i];
+			const uint32_t* b = &c.particle2[i];
+
+			// SSE has no gathers, the lanes are loaded one by one
+			__m128 xa = _mm_setr_ps(p.x[a[0]], p.x[a[1]], p.x[a[2]], p.x[a[3]]);
+			__m128 ya = _mm_setr_ps(p.y[a[0]], p.y[a[1]], p.y[a[2]], p.y[a[3]]);
+			__m128 za = _mm_setr_ps(p.z[a[0]], p.z[a[1]], p.z[a[2]], p.z[a[3]]);
+			__m128 xb = _mm_setr_ps(p.x[b[0]], p.x[b[1]], p.x[b[2]], p.x[b[3]]);
+			__m128 yb = _mm_setr_ps(p.y[b[0]], p.y[b[1]], p.y[b[2]], p.y[b[3]]);
+			__m128 zb = _mm_setr_ps(p.z[b[0]], p.z[b[1]], p.z[b[2]], p.z[b[3]]);
+			__m128 wa = _mm_setr_ps(p.inverseMass[a[0]], p.inverseMass[a[1]], p.inverseMass[a[2]], p.inverseMass[a[3]]);
+			__m128 wb = _mm_setr_ps(p.inverseMass[b[0]], p.inverseMass[b[1]], p.inverseMass[b[2]], p.inverseMass[b[3]]);
+
+			__m128 dx = _mm_sub_ps(xb, xa);
+			__m128 dy = _mm_sub_ps(yb, ya);
+			__m128 dz = _mm_sub_ps(zb, za);
+
+			__m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			__m128 w = _mm_add_ps(wa, wb);
+
+			// (1 - rest / dist) / w, zero when either is zero
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(squared, zero), _mm_cmpgt_ps(w, zero));
+			__m128 dist = _mm_sqrt_ps(squared);
+			__m128 s = _mm_div_ps(_mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(&c.restDistance[i]), dist)), w);
+			s = _mm_and_ps(valid, s);
+
+			__m128 sa = _mm_mul_ps(wa, s);
+			__m128 sb = _mm_mul_ps(wb, s);
+
+			alignas(16) float out[6][4];
+			_mm_store_ps(out[0], _mm_add_ps(xa, _mm_mul_ps(sa, dx)));
+			_mm_store_ps(out[1], _mm_add_ps(ya, _mm_mul_ps(sa, dy)));
+			_mm_store_ps(out[2], _mm_add_ps(za, _mm_mul_ps(sa, dz)));
+			_mm_store_ps(out[3], _mm_sub_ps(xb, _mm_mul_ps(sb, dx)));
+			_mm_store_ps(out[4], _mm_sub_ps(yb, _mm_mul_ps(sb, dy)));
+			_mm_store_ps(out[5], _mm_sub_ps(zb, _mm_mul_ps(sb, dz)));
+
+			// Lanes of one color never share a particle, the scattered
+			// stores do not overlap
+			for (int lane = 0; lane < 4; lane++)
+			{
+				p.x[a[lane]] = out[0][lane];
+				p.y[a[lane]] = out[1][lane];
+				p.z[a[lane]] = out[2][lane];
+				p.x[b[lane]] = out[3][lane];
+				p.y[b[lane]] = out[4][lane];
+				p.z[b[lane]] = out[5][lane];
+			}
+		}
+
+		ProjectConstraintsScalar(p, c, i, end);
+	}
+
+	static void ProjectConstraintsXPBDSSE(ClothParticles& p, ClothConstraints& c, uint32_t begin, uint32_t end, float timeStep)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 inverseDt2 = _mm_set1_ps(1.0f / (timeStep * timeStep));
+
+		uint32_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			const uint32_t* a = &c.particle1[i];
+			const uint32_t* b = &c.particle2[i];
+
+			__m128 xa = _mm_setr_ps(p.x[a[0]], p.x[a[1]], p.x[a[2]], p.x[a[3]]);
+			__m128 ya = _mm_setr_ps(p.y[a[0]], p.y[a[1]], p.y[a[2]], p.y[a[3]]);
+			__m128 za = _mm_setr_ps(p.z[a[0]], p.z[a[1]], p.z[a[2]], p.z[a[3]]);
+			__m128 xb = _mm_setr_ps(p.x[b[0]], p.x[b[1]], p.x[b[2]], p.x[b[3]]);
+			__m128 yb = _mm_setr_ps(p.y[b[0]], p.y[b[1]], p.y[b[2]], p.y[b[3]]);
+			__m128 zb = _mm_setr_ps(p.z[b[0]], p.z[b[1]], p.z[b[2]], p.z[b[3]]);
+			__m128 wa = _mm_setr_ps(p.inverseMass[a[0]], p.inverseMass[a[1]], p.inverseMass[a[2]], p.inverseMass[a[3]]);
+			__m128 wb = _mm_setr_ps(p.inverseMass[b[0]], p.inverseMass[b[1]], p.inverseMass[b[2]], p.inverseMass[b[3]]);
+
+			__m128 dx = _mm_sub_ps(xb, xa);
+			__m128 dy = _mm_sub_ps(yb, ya);
+			__m128 dz = _mm_sub_ps(zb, za);
+
+			__m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+			__m128 alpha = _mm_mul_ps(_mm_loadu_ps(&c.compliance[i]), inverseDt2);
+			__m128 w = _mm_add_ps(_mm_add_ps(wa, wb), alpha);
+			__m128 lambda = _mm_loadu_ps(&c.lambda[i]);
+
+			// (rest - dist - alpha * lambda) / w, zero when dist or w is zero
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(squared, zero), _mm_cmpgt_ps(w, zero));
+			__m128 dist = _mm_sqrt_ps(squared);
+			__m128 deltaLambda = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(&c.restDistance[i]), dist), _mm_mul_ps(alpha, lambda)), w);
+			deltaLambda = _mm_and_ps(valid, deltaLambda);
+			_mm_storeu_ps(&c.lambda[i], _mm_add_ps(lambda, deltaLambda));
+
+			__m128 s = _mm_and_ps(valid, _mm_div_ps(deltaLambda, dist));
+			__m128 sa = _mm_mul_ps(wa, s);
+			__m128 sb = _mm_mul_ps(wb, s);
+
+			alignas(16) float out[6][4];
+			_mm_store_ps(out[0], _mm_sub_ps(xa, _mm_mul_ps(sa, dx)));
+			_mm_store_ps(out[1], _mm_sub_ps(ya, _mm_mul_ps(sa, dy)));
+			_mm_store_ps(out[2], _mm_sub_ps(za, _mm_mul_ps(sa, dz)));
+			_mm_store_ps(out[3], _mm_add_ps(xb, _mm_mul_ps(sb, dx)));
+			_mm_store_ps(out[4], _mm_add_ps(yb, _mm_mul_ps(sb, dy)));
+			_mm_store_ps(out[5], _mm_add_ps(zb, _mm_mul_ps(sb, dz)));
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				p.x[a[lane]] = out[0][lane];
+				p.y[a[lane]] = out[1][lane];
+				p.z[a[lane]] = out[2][lane];
+				p.x[b[lane]] = out[3][lane];
+				p.y[b[lane]] = out[4][lane];
+				p.z[b[lane]] = out[5][lane];
+			}
+		}
+
+		ProjectConstraintsXPBDScalar(p, c, i, end, timeStep);
+	}
+
+	// ************* AVX2 *************
+
+	GP_TARGET_AVX2 static void IntegrateAVX2(ClothParticles& p, uint32_t begin, uint32_t end, const VerletSpecs& specs)
+	{
+		const __m256 damping = _mm256_set1_ps(1.0f - specs.damping);
+		const __m256 dt2 = _mm256_set1_ps(specs.timeStep * specs.timeStep);
+		const __m256 zero = _mm256_setzero_ps();
+
+		float* positions[3] = { p.x.data(), p.y.data(), p.z.data() };
+		float* oldPositions[3] = { p.oldX.data(), p.oldY.data(), p.oldZ.data() };
+		const float* accelerations[3] = { p.accelerationX.data(), p.accelerationY.data(), p.accelerationZ.data() };
+		const float gravity[3] = { specs.gravity.x, specs.gravity.y, specs.gravity.z };
+
+		uint32_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 moving = _mm256_cmp_ps(_mm256_loadu_ps(&p.inverseMass[i]), zero, _CMP_NEQ_OQ);
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				__m256 x = _mm256_loadu_ps(positions[axis] + i);
+				__m256 old = _mm256_loadu_ps(oldPositions[axis] + i);
+				__m256 a = _mm256_add_ps(_mm256_loadu_ps(accelerations[axis] + i), _mm256_set1_ps(gravity[axis]));
+
+				__m256 next = _mm256_add_ps(x, _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(x, old), damping), _mm256_mul_ps(a, dt2)));
+
+				_mm256_storeu_ps(positions[axis] + i, _mm256_blendv_ps(x, next, moving));
+				_mm256_storeu_ps(oldPositions[axis] + i, _mm256_blendv_ps(old, x, moving));
+			}
+		}
+
+		IntegrateScalar(p, i, end, specs);
+	}
+
+	GP_TARGET_AVX2 static void ProjectConstraintsAVX2(ClothParticles& p, const ClothConstraints& c, uint32_t begin, uint32_t end)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 threeHalves = _mm256_set1_ps(1.5f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+
+		uint32_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			const uint32_t* a = &c.particle1[i];
+			const uint32_t* b = &c.particle2[i];
+
+			__m256i ia = _mm256_loadu_si256((const __m256i*)a);
+			__m256i ib = _mm256_loadu_si256((const __m256i*)b);
+
+			__m256 xa = _mm256_i32gather_ps(p.x.data(), ia, 4);
+			__m256 ya = _mm256_i32gather_ps(p.y.data(), ia, 4);
+			__m256 za = _mm256_i32gather_ps(p.z.data(), ia, 4);
+			__m256 xb = _mm256_i32gather_ps(p.x.data(), ib, 4);
+			__m256 yb = _mm256_i32gather_ps(p.y.data(), ib, 4);
+			__m256 zb = _mm256_i32gather_ps(p.z.data(), ib, 4);
+			__m256 wa = _mm256_i32gather_ps(p.inverseMass.data(), ia, 4);
+			__m256 wb = _mm256_i32gather_ps(p.inverseMass.data(), ib, 4);
+
+			__m256 dx = _mm256_sub_ps(xb, xa);
+			__m256 dy = _mm256_sub_ps(yb, ya);
+			__m256 dz = _mm256_sub_ps(zb, za);
+
+			__m256 squared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			__m256 w = _mm256_add_ps(wa, wb);
+
+			// Estimates of 1 / dist and 1 / w with one Newton step each
+			// instead of a square root and two divisions
+			__m256 inverseDist = _mm256_rsqrt_ps(squared);
+			inverseDist = _mm256_mul_ps(inverseDist,
+				_mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, squared), _mm256_mul_ps(inverseDist, inverseDist))));
+
+			__m256 inverseW = _mm256_rcp_ps(w);
+			inverseW = _mm256_mul_ps(inverseW, _mm256_sub_ps(two, _mm256_mul_ps(w, inverseW)));
+
+			// Lanes with a zero length or two pinned particles get inf or
+			// nan above and are masked out here
+			__m256 valid = _mm256_and_ps(_mm256_cmp_ps(squared, zero, _CMP_GT_OQ), _mm256_cmp_ps(w, zero, _CMP_GT_OQ));
+			__m256 s = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(_mm256_loadu_ps(&c.restDistance[i]), inverseDist)), inverseW);
+			s = _mm256_and_ps(valid, s);
+
+			__m256 sa = _mm256_mul_ps(wa, s);
+			__m256 sb = _mm256_mul_ps(wb, s);
+
+			// AVX2 has no scatter, the lanes are stored one by one. They
+			// never share a particle inside a color
+			alignas(32) float out[6][8];
+			_mm256_store_ps(out[0], _mm256_add_ps(xa, _mm256_mul_ps(sa, dx)));
+			_mm256_store_ps(out[1], _mm256_add_ps(ya, _mm256_mul_ps(sa, dy)));
+			_mm256_store_ps(out[2], _mm256_add_ps(za, _mm256_mul_ps(sa, dz)));
+			_mm256_store_ps(out[3], _mm256_sub_ps(xb, _mm256_mul_ps(sb, dx)));
+			_mm256_store_ps(out[4], _mm256_sub_ps(yb, _mm256_mul_ps(sb, dy)));
+			_mm256_store_ps(out[5], _mm256_sub_ps(zb, _mm256_mul_ps(sb, dz)));
+
+			for (int lane = 0; lane < 8; lane++)
+			{
+				p.x[a[lane]] = out[0][lane];
+				p.y[a[lane]] = out[1][lane];
+				p.z[a[lane]] = out[2][lane];
+				p.x[b[lane]] = out[3][lane];
+				p.y[b[lane]] = out[4][lane];
+				p.z[b[lane]] = out[5][lane];
+			}
+		}
+
+		ProjectConstraintsScalar(p, c, i, end);
+	}
+
+	GP_TARGET_AVX2 static void ProjectConstraintsXPBDAVX2(ClothParticles& p, ClothConstraints& c, uint32_t begin, uint32_t end, float timeStep)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 threeHalves = _mm256_set1_ps(1.5f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 inverseDt2 = _mm256_set1_ps(1.0f / (timeStep * timeStep));
+
+		uint32_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			const uint32_t* a = &c.particle1[i];
+			const uint32_t* b = &c.particle2[i];
+
+			__m256i ia = _mm256_loadu_si256((const __m256i*)a);
+			__m256i ib = _mm256_loadu_si256((const __m256i*)b);
+
+			__m256 xa = _mm256_i32gather_ps(p.x.data(), ia, 4);
+			__m256 ya = _mm256_i32gather_ps(p.y.data(), ia, 4);
+			__m256 za = _mm256_i32gather_ps(p.z.data(), ia, 4);
+			__m256 xb = _mm256_i32gather_ps(p.x.data(), ib, 4);
+			__m256 yb = _mm256_i32gather_ps(p.y.data(), ib, 4);
+			__m256 zb = _mm256_i32gather_ps(p.z.data(), ib, 4);
+			__m256 wa = _mm256_i32gather_ps(p.inverseMass.data(), ia, 4);
+			__m256 wb = _mm256_i32gather_ps(p.inverseMass.data(), ib, 4);
+
+			__m256 dx = _mm256_sub_ps(xb, xa);
+			__m256 dy = _mm256_sub_ps(yb, ya);
+			__m256 dz = _mm256_sub_ps(zb, za);
+
+			__m256 squared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+			__m256 alpha = _mm256_mul_ps(_mm256_loadu_ps(&c.compliance[i]), inverseDt2);
+			__m256 w = _mm256_add_ps(_mm256_add_ps(wa, wb), alpha);
+			__m256 lambda = _mm256_loadu_ps(&c.lambda[i]);
+
+			__m256 inverseDist = _mm256_rsqrt_ps(squared);
+			inverseDist = _mm256_mul_ps(inverseDist,
+				_mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, squared), _mm256_mul_ps(inverseDist, inverseDist))));
+
+			__m256 inverseW = _mm256_rcp_ps(w);
+			inverseW = _mm256_mul_ps(inverseW, _mm256_sub_ps(two, _mm256_mul_ps(w, inverseW)));
+
+			__m256 valid = _mm256_and_ps(_mm256_cmp_ps(squared, zero, _CMP_GT_OQ), _mm256_cmp_ps(w, zero, _CMP_GT_OQ));
+			__m256 dist = _mm256_mul_ps(squared, inverseDist);
+			__m256 deltaLambda = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(&c.restDistance[i]), dist), _mm256_mul_ps(alpha, lambda)), inverseW);
+			deltaLambda = _mm256_and_ps(valid, deltaLambda);
+			_mm256_storeu_ps(&c.lambda[i], _mm256_add_ps(lambda, deltaLambda));
+
+			__m256 s = _mm256_and_ps(valid, _mm256_mul_ps(deltaLambda, inverseDist));
+			__m256 sa = _mm256_mul_ps(wa, s);
+			__m256 sb = _mm256_mul_ps(wb, s);
+
+			alignas(32) float out[6][8];
+			_mm256_store_ps(out[0], _mm256_sub_ps(xa, _mm256_mul_ps(sa, dx)));
+			_mm256_store_ps(out[1], _mm256_sub_ps(ya, _mm256_mul_ps(sa, dy)));
+			_mm256_store_ps(out[2], _mm256_sub_ps(za, _mm256_mul_ps(sa, dz)));
+			_mm256_store_ps(out[3], _mm256_add_ps(xb, _mm256_mul_ps(sb, dx)));
+			_mm256_store_ps(out[4], _mm256_add_ps(yb, _mm256_mul_ps(sb, dy)));
+			_mm256_store_ps(out[5], _mm256_add_ps(zb, _mm256_mul_ps(sb, dz)));
+
+			for (int lane = 0; lane < 8; lane++)
+			{
+				p.x[a[lane]] = out[0][lane];
+				p.y[a[lane]] = out[1][lane];
+				p.z[a[lane]] = out[2][lane];
+				p.x[b[lane]] = out[3][lane];
+				p.y[b[lane]] = out[4][lane];
+				p.z[b[lane]] = out[5][lane];
+			}
+		}
+
+		ProjectConstraintsXPBDScalar(p, c, i, end, timeStep);
+	}
+
+	static bool SupportsAVX2()
+	{
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// The OS has to save the upper halves of the registers too
+		__cpuid(info, 1);
+		bool osSupport = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+		if (!osSupport || (_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2");
+	#endif
+	}
+
+#endif
+
+	bool ClothKernels::IsSupported(SimdLevel level)
+	{
+	#ifdef GP_CLOTH_X86
+		static const bool avx2 = SupportsAVX2();
+
+		switch (level)
+		{
+			case(SimdLevel::SCALAR): return true;
+			case(SimdLevel::SSE):    return true;
+			case(SimdLevel::AVX2):   return avx2;
+		}
+
+		return false;
+	#else
+		return level == SimdLevel::SCALAR;
+	#endif
+	}
+
+	const char* ClothKernels::GetName(SimdLevel level)
+	{
+		switch (level)
+		{
+			case(SimdLevel::SCALAR): return "Scalar";
+			case(SimdLevel::SSE):    return "SSE";
+			case(SimdLevel::AVX2):   return "AVX2";
+		}
+
+		return "";
+	}
+
+	const ClothKernels& ClothKernels::Get(SimdLevel level)
+	{
+		static const ClothKernels kernels[] =
+		{
+			{ SimdLevel::SCALAR, IntegrateScalar, ProjectConstraintsScalar, ProjectConstraintsXPBDScalar },
+		#ifdef GP_CLOTH_X86
+			{ SimdLevel::SSE,    IntegrateSSE,    ProjectConstraintsSSE,    ProjectConstraintsXPBDSSE },
+			{ SimdLevel::AVX2,   IntegrateAVX2,   ProjectConstraintsAVX2,   ProjectConstraintsXPBDAVX2 }
+		#endif
+		};
+
+		int index = (int)level;
+		while (index > 0 && (index >= (int)(sizeof(kernels) / sizeof(kernels[0])) || !IsSupported((SimdLevel)index)))
+			index--;
+
+		return kernels[index];
+	}
+
+	const ClothKernels& ClothKernels::Get()
+	{
+		static const ClothKernels& kernels = []() -> const ClothKernels&
+		{
+			const ClothKernels& widest = Get(SimdLevel::AVX2);
+			GP_TRACE("Cloth kernels use {0}", GetName(widest.level));
+			return widest;
+		}();
+
+		return kernels;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <Cloth/ClothParticles.h>
+#include <Cloth/ClothConstraints.h>
+
+namespace GP
+{
+	enum class SimdLevel
+	{
+		SCALAR = 0,
+		// 4 lanes, part of every x64 CPU
+		SSE = 1,
+		// 8 lanes with hardware gathers
+		AVX2 = 2
+	};
+
+	struct VerletSpecs
+	{
+		// Fraction of the velocity lost in one step
+		float damping = 0.01f;
+		float timeStep = 0.00625f;
+		glm::vec3 gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+	};
+
+	// Inner loops of the cloth solver, one implementation per instruction
+	// set. Every kernel works on a range so the callers can split the
+	// work over threads, and ranges that are not a multiple of the lane
+	// count finish with the scalar loop. Get() picks the widest set the
+	// CPU supports the first time it is called.
+	struct ClothKernels
+	{
+		SimdLevel level = SimdLevel::SCALAR;
+
+		// Verlet step of particles [begin, end) under gravity and the
+		// accumulated acceleration, pinned particles stay
+		void (*integrate)(ClothParticles& particles, uint32_t begin, uint32_t end, const VerletSpecs& specs) = nullptr;
+
+		// Distance constraints [begin, end), which have to be inside one
+		// color so no particle is written by two lanes. Every constraint
+		// is fully satisfied, stiffness depends on the iteration count
+		void (*projectConstraints)(ClothParticles& particles, const ClothConstraints& constraints, uint32_t begin, uint32_t end) = nullptr;
+
+		// Same batches with compliance, stiffness does not depend on the
+		// iteration count. timeStep is the substep length, the multipliers
+		// of the constraints are updated in place
+		void (*projectConstraintsXPBD)(ClothParticles& particles, ClothConstraints& constraints, uint32_t begin, uint32_t end, float timeStep) = nullptr;
+
+		static const ClothKernels& Get();
+
+		// Falls back to the widest supported set below level
+		static const ClothKernels& Get(SimdLevel level);
+
+		static bool IsSupported(SimdLevel level);
+		static const char* GetName(SimdLevel level);
+	};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace GP
+{
+	// Structure of arrays particle store, every coordinate is its own
+	// contiguous array so the solver passes stream through memory and
+	// can be vectorized. Particles with a zero inverse mass are pinned.
+	struct ClothParticles
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+
+		// Positions of the previous step, velocity is implicit in Verlet
+		std::vector<float> oldX;
+		std::vector<float> oldY;
+		std::vector<float> oldZ;
+
+		std::vector<float> inverseMass;
+
+		// Sum of the force accelerations of the current step, cleared
+		// when the particles are integrated
+		std::vector<float> accelerationX;
+		std::vector<float> accelerationY;
+		std::vector<float> accelerationZ;
+
+		void Resize(uint32_t count)
+		{
+			x.resize(count);
+			y.resize(count);
+			z.resize(count);
+			oldX.resize(count);
+			oldY.resize(count);
+			oldZ.resize(count);
+			inverseMass.resize(count, 1.0f);
+			accelerationX.resize(count, 0.0f);
+			accelerationY.resize(count, 0.0f);
+			accelerationZ.resize(count, 0.0f);
+		}
+
+		uint32_t GetCount() const { return (uint32_t)x.size(); }
+
+		glm::vec3 GetPosition(uint32_t index) const { return glm::vec3(x[index], y[index], z[index]); }
+
+		void SetPosition(uint32_t index, const glm::vec3& position)
+		{
+			x[index] = position.x;
+			y[index] = position.y;
+			z[index] = position.z;
+		}
+
+		// Moves the particle without giving it velocity
+		void Reset(uint32_t index, const glm::vec3& position)
+		{
+			SetPosition(index, position);
+			oldX[index] = position.x;
+			oldY[index] = position.y;
+			oldZ[index] = position.z;
+		}
+	};
+}
@@ -0,0 +1,39 @@
+#include <Precomp.h>
+#include <Cloth/ClothSpatialHash.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+
+namespace GP
+{
+	void ClothSpatialHash::Build(const ClothParticles& particles, float cellSize)
+	{
+		Timer timer;
+
+		uint32_t count = particles.GetCount();
+
+		m_TableSize = std::max(1u, 2 * count);
+		m_InverseCellSize = 1.0f / cellSize;
+
+		m_SlotOffsets.assign(m_TableSize + 1, 0);
+		m_Entries.resize(count);
+		m_ParticleSlots.resize(count);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t slot = Hash(GetCell(particles.x[i]), GetCell(particles.y[i]), GetCell(particles.z[i]));
+			m_ParticleSlots[i] = slot;
+			m_SlotOffsets[slot]++;
+		}
+
+		// Offsets first point past the end of their slot, filling back
+		// to front moves each one to the start of its slot
+		for (uint32_t s = 1; s < m_TableSize; s++)
+			m_SlotOffsets[s] += m_SlotOffsets[s - 1];
+		m_SlotOffsets[m_TableSize] = count;
+
+		for (int i = (int)count - 1; i >= 0; i--)
+			m_Entries[--m_SlotOffsets[m_ParticleSlots[i]]] = i;
+
+		m_BuildTime = timer.ElapsedMilliseconds();
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Cloth/ClothParticles.h>
+
+namespace GP
+{
+	// Dense hash of the particle positions. Space is split into cubic
+	// cells that hash into a table twice the particle count, and a
+	// counting sort puts the particles of every table slot next to each
+	// other, so a rebuild is linear and allocates nothing after the
+	// first one.
+	class ClothSpatialHash
+	{
+	public:
+		ClothSpatialHash() {}
+
+		void Build(const ClothParticles& particles, float cellSize);
+
+		// Calls func(particle) for every particle within half a cell of
+		// position, and some more. Those lie in the 2x2x2 cells closest
+		// to it; other cells sharing a table slot come along too, the
+		// caller checks distances anyway
+		template<typename Func>
+		void Query(const glm::vec3& position, Func func) const
+		{
+			int cells[3][2];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float scaled = position[axis] * m_InverseCellSize;
+				int cell = (int)std::floor(scaled);
+				cells[axis][0] = cell;
+				cells[axis][1] = (scaled - cell < 0.5f) ? cell - 1 : cell + 1;
+			}
+
+			// Neighbor cells can share a slot, each slot is visited once
+			uint32_t visited[8];
+			uint32_t visitedCount = 0;
+
+			for (int x = 0; x < 2; x++)
+			{
+				for (int y = 0; y < 2; y++)
+				{
+					for (int z = 0; z < 2; z++)
+					{
+						uint32_t slot = Hash(cells[0][x], cells[1][y], cells[2][z]);
+
+						bool seen = false;
+						for (uint32_t i = 0; i < visitedCount && !seen; i++)
+							seen = visited[i] == slot;
+
+						if (seen)
+							continue;
+
+						visited[visitedCount++] = slot;
+
+						for (uint32_t i = m_SlotOffsets[slot]; i < m_SlotOffsets[slot + 1]; i++)
+							func(m_Entries[i]);
+					}
+				}
+			}
+		}
+
+		float GetBuildTime() const { return m_BuildTime; }
+
+	private:
+		int GetCell(float coordinate) const { return (int)std::floor(coordinate * m_InverseCellSize); }
+
+		uint32_t Hash(int x, int y, int z) const
+		{
+			uint32_t h = ((uint32_t)x * 92837111u) ^ ((uint32_t)y * 689287499u) ^ ((uint32_t)z * 283923481u);
+			return h % m_TableSize;
+		}
+
+	private:
+		uint32_t m_TableSize = 1;
+		float m_InverseCellSize = 1.0f;
+
+		// Particles sorted by slot, slot s holds [m_SlotOffsets[s], m_SlotOffsets[s + 1])
+		std::vector<uint32_t> m_SlotOffsets;
+		std::vector<uint32_t> m_Entries;
+		std::vector<uint32_t> m_ParticleSlots;
+
+		float m_BuildTime = 0.0f;
+	};
+}
@@ -11,6 +11,9 @@
 
 #include <GeoProcess/System/GuiSystem/Font/Font.h>
 
+#include <Benchmark/GeodesicBenchmark.h>
+#include <Benchmark/ClothBenchmark.h>
+
 #include <glad/glad.h>
 
 namespace GP
@@ -138,9 +141,7 @@ namespace GP
 		m_EditorCamera.OnUpdate(ts);
 
 		// step cloth
-		
-		MainRender::GetEditorMesh()->Step();
-		MainRender::GetEditorMesh()->SphereCollision(MainRender::GetModelTransform(), 0.5f);
+		MainRender::StepCloth();
 
 		MainRender::Render(m_EditorCamera, ts);
 
@@ -191,6 +192,31 @@ namespace GP
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::BeginMenu("Benchmarks"))
+			{
+				if (ImGui::MenuItem("Geodesic Distances"))
+				{
+					GeodesicBenchmark::Run();
+				}
+
+				if (ImGui::MenuItem("Exact Geodesic Accuracy"))
+				{
+					GeodesicBenchmark::RunAccuracy();
+				}
+
+				if (ImGui::MenuItem("Spectral Descriptors"))
+				{
+					GeodesicBenchmark::RunSpectral();
+				}
+
+				if (ImGui::MenuItem("Cloth Kernels"))
+				{
+					ClothBenchmark::Run();
+				}
+
+				ImGui::EndMenu();
+			}
+
 			ImGui::EndMenuBar();
 		}
 
@@ -219,13 +245,88 @@ namespace GP
 				glDisable(GL_CULL_FACE);
 		}
 
+		// Edited on a copy, the cloth only rebuilds its constraints when
+		// shear or bending is toggled
+		ImGui::Separator();
+
+		// Larger cloths are opt-in, every step runs on this thread
+		const char* resolutionNames[] = { "101 x 101", "256 x 256", "512 x 512" };
+		const uint32_t resolutionDivisors[] = { 100, 255, 511 };
+		int resolution = 0;
+		for (int i = 0; i < IM_ARRAYSIZE(resolutionDivisors); i++)
+		{
+			if (resolutionDivisors[i] == MainRender::GetClothResolution())
+				resolution = i;
+		}
+
+		if (ImGui::Combo("Resolution", &resolution, resolutionNames, IM_ARRAYSIZE(resolutionNames)))
+			MainRender::SetClothResolution(resolutionDivisors[resolution]);
+
+		ClothSettings clothSettings = MainRender::GetEditorMesh()->GetSettings();
+		bool clothChanged = false;
+
+		const char* solverNames[] = { "PBD", "XPBD" };
+		int solver = (int)clothSettings.solver;
+		if (ImGui::Combo("Solver", &solver, solverNames, IM_ARRAYSIZE(solverNames)))
+		{
+			clothSettings.solver = (ClothSolver)solver;
+			clothChanged = true;
+		}
+
+		int substeps = (int)clothSettings.substeps;
+		if (ImGui::SliderInt("Substeps", &substeps, 1, 32))
+		{
+			clothSettings.substeps = (uint32_t)substeps;
+			clothChanged = true;
+		}
+
+		int iterations = (int)clothSettings.iterations;
+		if (ImGui::SliderInt("Iterations", &iterations, 1, 32))
+		{
+			clothSettings.iterations = (uint32_t)iterations;
+			clothChanged = true;
+		}
+
+		clothChanged |= ImGui::DragFloat("Time Step", &clothSettings.timeStep, 0.0001f, 0.0001f, 0.05f, "%.5f");
+		clothChanged |= ImGui::DragFloat("Damping", &clothSettings.damping, 0.001f, 0.0f, 1.0f);
+		clothChanged |= ImGui::DragFloat3("Gravity", glm::value_ptr(clothSettings.gravity), 0.1f);
+		clothChanged |= ImGui::DragFloat3("Wind", glm::value_ptr(clothSettings.wind), 0.1f);
+		clothChanged |= ImGui::Checkbox("Shear Constraints", &clothSettings.shear);
+		clothChanged |= ImGui::Checkbox("Bending Constraints", &clothSettings.bending);
+
+		if (clothSettings.solver == ClothSolver::XPBD)
+		{
+			clothChanged |= ImGui::DragFloat("Structural Compliance", &clothSettings.structuralCompliance, 0.0000001f, 0.0f, 1.0f, "%.8f");
+			clothChanged |= ImGui::DragFloat("Shear Compliance", &clothSettings.shearCompliance, 0.0000001f, 0.0f, 1.0f, "%.8f");
+			clothChanged |= ImGui::DragFloat("Bending Compliance", &clothSettings.bendingCompliance, 0.000001f, 0.0f, 1.0f, "%.8f");
+		}
+
+		ImGui::Checkbox("Mesh Collider", MainRender::GetMeshCollider());
+		clothChanged |= ImGui::DragFloat("Collision Thickness", &clothSettings.collisionThickness, 0.001f, 0.0f, 1.0f);
+		clothChanged |= ImGui::DragFloat("Friction", &clothSettings.friction, 0.01f, 0.0f, 1.0f);
+
+		clothChanged |= ImGui::Checkbox("Self Collision", &clothSettings.selfCollision);
+		if (clothSettings.selfCollision)
+			clothChanged |= ImGui::DragFloat("Self Collision Distance", &clothSettings.selfCollisionDistance, 0.01f, 0.0f, 2.0f);
+
+		if (clothChanged)
+			MainRender::GetEditorMesh()->SetSettings(clothSettings);
+
+		ImGui::Text("Step Time %.2f ms", MainRender::GetEditorMesh()->GetStepTime());
+		if (clothSettings.selfCollision)
+		{
+			const ClothSelfCollisionStats& selfCollisionStats = MainRender::GetEditorMesh()->GetSelfCollisionStats();
+			ImGui::Text("Hash Build %.3f ms, Query %.3f ms, %u Contacts", selfCollisionStats.hashBuildTime,
+				selfCollisionStats.queryTime, selfCollisionStats.contactCount);
+		}
+
 		ImGui::PopStyleVar();
 		ImGui::End();
 		ImGui::PopStyleVar();
 		ImGui::End();
 
 		/*int currentSelectedIDMethod = MainRender::GetEditorMesh()->m_GeodesicDistanceCalcMethod;
-		std::vector<std::string> calcMethodNames = { "Min Heap", "Array" };
+		std::vector<std::string> calcMethodNames = { "Min Heap", "Array", "Indexed Heap", "Exact (ICH)", "Heat Method" };
 		if (ImGui::BeginCombo("CalcMethod", MainRender::GetEditorMesh()->GiveCalcMethodName().c_str(), ImGuiComboFlags_PopupAlignLeft))
 		{
 			for (int i = 0; i < calcMethodNames.size(); i++)
@@ -246,7 +347,7 @@ namespace GP
 		}*/
 
 		/*int currentSelectedIDRenderMode = (int)MainRender::GetEditorMesh()->m_RenderSpecs.renderMode;
-		std::vector<std::string> renderModeNames = { "AGD", "Flat", "GC", "Triangle Quality", "Smooth"};
+		std::vector<std::string> renderModeNames = { "AGD", "Flat", "GC", "Triangle Quality", "Smooth", "Scalar Field"};
 		if (ImGui::BeginCombo("Render Mode", MainRender::GetEditorMesh()->GiveRenderMethodName().c_str(), ImGuiComboFlags_PopupAlignLeft))
 		{
 			for (int i = 0; i < renderModeNames.size(); i++)
@@ -255,7 +356,7 @@ namespace GP
 				if (ImGui::Selectable(renderModeNames[i].c_str(), isSelected))
 				{
 					currentSelectedIDRenderMode = i;
-					MainRender::GetEditorMesh()->m_RenderSpecs.renderMode = (RENDERMODE)i;
+					MainRender::GetEditorMesh()->SetRenderMode((RENDERMODE)i);
 				}
 
 				if (isSelected)
@@ -264,10 +365,33 @@ namespace GP
 				}
 			}
 			ImGui::EndCombo();
-		}*/
+		}
+
+		// Only uniforms change here, no color is recomputed
+		RenderSpecs& specs = MainRender::GetEditorMesh()->m_RenderSpecs;
+		const char* colormapNames[] = { "Red Blue", "Viridis", "Grayscale" };
+		int colormap = (int)specs.colormap;
+		if (ImGui::Combo("Colormap", &colormap, colormapNames, IM_ARRAYSIZE(colormapNames)))
+			specs.colormap = (COLORMAP)colormap;
+		ImGui::Checkbox("Auto Scalar Range", &specs.autoScalarRange);
+		if (specs.autoScalarRange)
+		{
+			glm::vec2 range = MainRender::GetEditorMesh()->GetScalarRange(specs.renderMode);
+			specs.scalarMin = range.x;
+			specs.scalarMax = range.y;
+		}
+		ImGui::DragFloat("Scalar Min", &specs.scalarMin, 0.01f);
+		ImGui::DragFloat("Scalar Max", &specs.scalarMax, 0.01f);*/
 
 
 		/*ImGui::Text("Distance Calc Time %f", MainRender::GetEditorMesh()->m_CalcTime);
+		const char* pathQueryModeNames[] = { "Full", "Early Exit", "Bidirectional", "A*" };
+		int pathQueryMode = (int)MainRender::GetEditorMesh()->m_PathQueryMode;
+		if (ImGui::Combo("Path Query", &pathQueryMode, pathQueryModeNames, IM_ARRAYSIZE(pathQueryModeNames)))
+		{
+			MainRender::GetEditorMesh()->m_PathQueryMode = (PathQueryMode)pathQueryMode;
+			MainRender::GetEditorMesh()->SetupLineVertices();
+		}
 		if (ImGui::InputInt("StartIndex", MainRender::GetGeoDistStartIndex()))
 		{
 			MainRender::GetEditorMesh()->SetupLineVertices();
@@ -283,12 +407,33 @@ namespace GP
 		}
 		ImGui::Checkbox("Show Line", MainRender::GetShowLine());
 		ImGui::Checkbox("Show Samples", &MainRender::GetEditorMesh()->m_RenderSpecs.showSamples);
+		SmoothingSpecs& smoothingSpecs = MainRender::GetEditorMesh()->m_SmoothingSpecs;
+		const char* smoothingModeNames[] = { "Explicit", "Implicit", "Mean Curvature Flow" };
+		int smoothingMode = (int)smoothingSpecs.mode;
+		if (ImGui::Combo("Smoothing Mode", &smoothingMode, smoothingModeNames, IM_ARRAYSIZE(smoothingModeNames)))
+			smoothingSpecs.mode = (SmoothingMode)smoothingMode;
+		bool cotangentWeights = smoothingSpecs.laplacian == LaplacianType::COTANGENT;
+		if (ImGui::Checkbox("Cotangent Weights", &cotangentWeights))
+			smoothingSpecs.laplacian = cotangentWeights ? LaplacianType::COTANGENT : LaplacianType::UNIFORM;
+		ImGui::DragFloat("Smoothing Step", &smoothingSpecs.stepSize, 0.1f, 0.0f, 1000.0f);
+		int smoothingIterations = (int)smoothingSpecs.iterations;
+		if (ImGui::InputInt("Smoothing Iterations", &smoothingIterations))
+			smoothingSpecs.iterations = (uint32_t)std::max(1, smoothingIterations);
 		if (ImGui::Button("Smoothing Function"))
 		{
 			MainRender::GetEditorMesh()->SmoothingFunction();
 		}
 
 
+		DistanceMatrixSpecs& exportSpecs = MainRender::GetEditorMesh()->m_ExportSpecs;
+		ImGui::Checkbox("Binary Matrix", &exportSpecs.binary);
+		bool halfPrecision = exportSpecs.precision == DistanceMatrixPrecision::FLOAT16;
+		if (ImGui::Checkbox("Half Precision", &halfPrecision))
+			exportSpecs.precision = halfPrecision ? DistanceMatrixPrecision::FLOAT16 : DistanceMatrixPrecision::FLOAT32;
+		bool upperTriangle = exportSpecs.storage == DistanceMatrixStorage::UPPER_TRIANGLE;
+		if (ImGui::Checkbox("Upper Triangle Only", &upperTriangle))
+			exportSpecs.storage = upperTriangle ? DistanceMatrixStorage::UPPER_TRIANGLE : DistanceMatrixStorage::FULL;
+
 		if (ImGui::Button("Export Distance Matrix") && !m_ExportInProgress)
 		{
 			m_ExportState = MainRender::GetEditorMesh()->ExportGDM();
@@ -301,13 +446,23 @@ namespace GP
 		}
 		else if (m_ExportState.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
 		{
-			ImGui::Text("Export Finished");
-			m_ExportState.get();
+			// The new matrix is mapped here, the export thread never
+			// touches the one the distance queries read from
+			if (m_ExportState.get())
+			{
+				ImGui::Text("Export Finished");
+				MainRender::GetEditorMesh()->LoadGDM();
+			}
+			else
+			{
+				ImGui::Text("Export Failed");
+			}
+
 			m_ExportInProgress = false;
 		}
 		else
 		{
-			ImGui::Text("Exporting...");
+			ImGui::Text("Exporting... %.1f%%", MainRender::GetEditorMesh()->GetExportProgress() * 100.0f);
 		}
 
 		ImGui::PopStyleVar();
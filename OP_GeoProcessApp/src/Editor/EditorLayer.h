@@ -58,7 +58,7 @@ namespace GP
 		glm::mat4 m_ModelTransform;
 
 		bool m_ExportInProgress = false;
-		std::future<void> m_ExportState;
+		std::future<bool> m_ExportState;
 	private:
 		static EditorLayer* s_Instance;
 
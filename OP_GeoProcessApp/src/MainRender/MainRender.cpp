@@ -79,6 +79,14 @@ namespace GP
 
 		// ------- CLOTH ------ //
 		Ref<Cloth> cloth;
+		// Quads per side. The cloth steps on the UI thread every frame,
+		// 512 x 512 particles (511) only when selected in the editor
+		uint32_t clothDivisor = 100;
+		Ref<ClothCollider> clothCollider;
+		// Fits the model into the scale of the cloth
+		glm::mat4 colliderNormalization = glm::mat4(1.0f);
+		// The sphere is the default, the mesh collider is opt-in
+		bool meshCollider = false;
 
 		// ------ Meshes ------ //
 		Ref<Cube> cube;
@@ -130,11 +138,43 @@ namespace GP
 		s_RenderData.cube = Cube::Create();
 		s_RenderData.sphere = Icosphere::Create(0.4f, 3, true);
 
-		s_RenderData.cloth = Cloth::Create(6, 100);
+		s_RenderData.cloth = Cloth::Create(6, s_RenderData.clothDivisor);
 
 		// Initialize Model
 		s_RenderData.model = ResourceManager::GetModel("centaur");
 		// s_RenderData.editorMesh = EditorMesh::Create(s_RenderData.model);
+
+		// Collider of every mesh of the model, placed behind the cloth
+		// where the wind pushes it
+		std::vector<glm::vec3> colliderVertices;
+		std::vector<uint32_t> colliderIndices;
+		for (uint32_t i = 0; i < s_RenderData.model->GetMeshCount(); i++)
+		{
+			Ref<Mesh> mesh = s_RenderData.model->GetMesh(i).Mesh;
+			uint32_t offset = colliderVertices.size();
+
+			std::vector<glm::vec3> vertices = mesh->GetVertices();
+			colliderVertices.insert(colliderVertices.end(), vertices.begin(), vertices.end());
+
+			for (uint32_t index : mesh->GetIndicesVector())
+				colliderIndices.push_back(offset + index);
+		}
+
+		glm::vec3 boundsMin(std::numeric_limits<float>::max());
+		glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+		for (const glm::vec3& vertex : colliderVertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex);
+			boundsMax = glm::max(boundsMax, vertex);
+		}
+
+		glm::vec3 extent = boundsMax - boundsMin;
+		float largestExtent = std::max(std::max(extent.x, extent.y), std::max(extent.z, 0.0001f));
+		s_RenderData.colliderNormalization = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, -1.5f)) *
+			glm::scale(glm::mat4(1.0f), glm::vec3(3.0f / largestExtent)) *
+			glm::translate(glm::mat4(1.0f), -(boundsMin + boundsMax) * 0.5f);
+
+		s_RenderData.clothCollider = ClothCollider::Create(colliderVertices, colliderIndices);
  		s_RenderData.modelDatabase = ResourceManager::GetModelDatabase("FAUST");
 
 		/*s_RenderData.pcaDatabase = PCADatabase::Create(s_RenderData.modelDatabase);
@@ -306,6 +346,45 @@ namespace GP
 		return s_RenderData.cloth;
 	}
 
+	void MainRender::StepCloth()
+	{
+		if (s_RenderData.meshCollider)
+		{
+			// Refits only when the transform changed
+			s_RenderData.clothCollider->SetTransform(s_RenderData.modelTransform * s_RenderData.colliderNormalization);
+			s_RenderData.cloth->SetCollider(s_RenderData.clothCollider);
+			s_RenderData.cloth->Step();
+		}
+		else
+		{
+			s_RenderData.cloth->SetCollider(nullptr);
+			s_RenderData.cloth->Step();
+			s_RenderData.cloth->SphereCollision(s_RenderData.modelTransform, 0.5f);
+		}
+	}
+
+	bool* MainRender::GetMeshCollider()
+	{
+		return &s_RenderData.meshCollider;
+	}
+
+	void MainRender::SetClothResolution(uint32_t divisor)
+	{
+		if (divisor == s_RenderData.clothDivisor)
+			return;
+
+		s_RenderData.clothDivisor = divisor;
+
+		Ref<Cloth> cloth = Cloth::Create(6, divisor, s_RenderData.cloth->GetSettings());
+		cloth->m_RenderSpecs = s_RenderData.cloth->m_RenderSpecs;
+		s_RenderData.cloth = cloth;
+	}
+
+	uint32_t MainRender::GetClothResolution()
+	{
+		return s_RenderData.clothDivisor;
+	}
+
 	void MainRender::RenderChain(TimeStep ts)
 	{
 
@@ -317,9 +396,18 @@ namespace GP
 
 				
 				
-				s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform;
-				s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
-				s_RenderData.sphere->Draw();
+				if (s_RenderData.meshCollider)
+				{
+					s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform * s_RenderData.colliderNormalization;
+					s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
+					s_RenderData.model->Draw();
+				}
+				else
+				{
+					s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform;
+					s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
+					s_RenderData.sphere->Draw();
+				}
 			}
 		);
 
@@ -339,10 +427,19 @@ namespace GP
 											  ditheringTex);
 
 				
-				s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform;
-				s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
 				s_RenderData.mainShader->Bind();
-				s_RenderData.sphere->Draw();
+				if (s_RenderData.meshCollider)
+				{
+					s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform * s_RenderData.colliderNormalization;
+					s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
+					s_RenderData.model->Draw();
+				}
+				else
+				{
+					s_RenderData.TransformBuffer.Model = s_RenderData.modelTransform;
+					s_RenderData.TransformUniformBuffer->SetData(&s_RenderData.TransformBuffer, sizeof(RenderData::TransformData));
+					s_RenderData.sphere->Draw();
+				}
 				/*if (s_RenderData.editorMesh->m_RenderSpecs.showSamples)
 				{
 					for (auto& e : s_RenderData.editorMesh->m_SamplePoints)
@@ -399,6 +496,10 @@ namespace GP
 
 		s_RenderData.ToneMappingSettingsUniformBuffer->SetData(&s_RenderData.ToneMappingSettingsBuffer, sizeof(RenderData::ToneMappingSettings));
 
+		// Uploads the result of a background AGD pass once it finished
+		if (s_RenderData.editorMesh)
+			s_RenderData.editorMesh->UpdateDerivedData();
+
 		RenderChain(ts);
 	}
 
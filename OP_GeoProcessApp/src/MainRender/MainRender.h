@@ -53,6 +53,16 @@ namespace GP
 
 		static Ref<Cloth> GetEditorMesh();
 
+		// Steps the cloth against the mesh collider or the sphere, both
+		// follow the model transform
+		static void StepCloth();
+		static bool* GetMeshCollider();
+
+		// Quads per side of the cloth, a new resolution restarts it with
+		// the current settings
+		static void SetClothResolution(uint32_t divisor);
+		static uint32_t GetClothResolution();
+
 	private:
 
 	};
@@ -0,0 +1,267 @@
+#include <Precomp.h>
+#include <MeshOperations/DiscreteCurvature.h>
+
+#include <GeoProcess/System/Utils/ParallelFor.h>
+
+#include <glm/gtc/constants.hpp>
+
+namespace GP
+{
+	// Faces are handled in blocks, corner positions of a block are copied
+	// to small coordinate arrays first so the math runs as plain loops
+	// over contiguous floats
+	static const uint32_t BLOCK_SIZE = 64;
+
+	void DiscreteCurvature::Compute(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices)
+	{
+		Resize(topology);
+
+		ParallelFor(topology.GetVertexCount(), [&](uint32_t begin, uint32_t end)
+		{
+			LoadPositions(vertices, begin, end);
+		});
+
+		ParallelFor(topology.GetFaceCount(), [&](uint32_t begin, uint32_t end)
+		{
+			ComputeFaces(topology, nullptr, begin, end - begin);
+		});
+
+		ParallelFor(topology.GetVertexCount(), [&](uint32_t begin, uint32_t end)
+		{
+			GatherVertices(topology, nullptr, begin, end - begin);
+		});
+	}
+
+	void DiscreteCurvature::Update(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices,
+		                           const std::vector<uint32_t>& faces, const std::vector<uint32_t>& updatedVertices)
+	{
+		// Corner values of another mesh cannot be reused
+		if (m_CornerAngles.size() != topology.GetHalfEdgeCount() || m_X.size() != topology.GetVertexCount())
+		{
+			Compute(topology, vertices);
+			return;
+		}
+
+		ParallelFor((uint32_t)updatedVertices.size(), [&](uint32_t begin, uint32_t end)
+		{
+			LoadPositions(vertices, updatedVertices.data() + begin, end - begin);
+		});
+
+		ParallelFor((uint32_t)faces.size(), [&](uint32_t begin, uint32_t end)
+		{
+			ComputeFaces(topology, faces.data() + begin, 0, end - begin);
+		});
+
+		ParallelFor((uint32_t)updatedVertices.size(), [&](uint32_t begin, uint32_t end)
+		{
+			GatherVertices(topology, updatedVertices.data() + begin, 0, end - begin);
+		});
+	}
+
+	void DiscreteCurvature::Resize(const HalfEdgeMesh& topology)
+	{
+		uint32_t vertexCount = topology.GetVertexCount();
+		uint32_t cornerCount = topology.GetHalfEdgeCount();
+		uint32_t faceCount = topology.GetFaceCount();
+
+		for (auto* values : { &m_X, &m_Y, &m_Z,
+			                  &m_GaussianCurvatures, &m_MeanCurvatures,
+			                  &m_MaxCurvatures, &m_MinCurvatures, &m_VoronoiAreas })
+			values->resize(vertexCount);
+
+		for (auto* values : { &m_CornerAngles, &m_CornerAreas,
+			                  &m_CornerLaplacianX, &m_CornerLaplacianY, &m_CornerLaplacianZ })
+			values->resize(cornerCount);
+
+		for (auto* values : { &m_FaceNormalX, &m_FaceNormalY, &m_FaceNormalZ })
+			values->resize(faceCount);
+	}
+
+	void DiscreteCurvature::LoadPositions(const std::vector<glm::vec3>& vertices, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			m_X[i] = vertices[i].x;
+			m_Y[i] = vertices[i].y;
+			m_Z[i] = vertices[i].z;
+		}
+	}
+
+	void DiscreteCurvature::LoadPositions(const std::vector<glm::vec3>& vertices, const uint32_t* list, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t vertex = list[i];
+			m_X[vertex] = vertices[vertex].x;
+			m_Y[vertex] = vertices[vertex].y;
+			m_Z[vertex] = vertices[vertex].z;
+		}
+	}
+
+	void DiscreteCurvature::ComputeFaces(const HalfEdgeMesh& topology, const uint32_t* faces, uint32_t firstFace, uint32_t count)
+	{
+		const std::vector<uint32_t>& indices = topology.GetIndices();
+
+		// Corners of a face are a, b and c in index order
+		uint32_t faceIds[BLOCK_SIZE];
+		float ax[BLOCK_SIZE], ay[BLOCK_SIZE], az[BLOCK_SIZE];
+		float bx[BLOCK_SIZE], by[BLOCK_SIZE], bz[BLOCK_SIZE];
+		float cx[BLOCK_SIZE], cy[BLOCK_SIZE], cz[BLOCK_SIZE];
+
+		// Per corner results of the block, [0] is a, [1] is b, [2] is c
+		float angles[3][BLOCK_SIZE], areas[3][BLOCK_SIZE];
+		float lx[3][BLOCK_SIZE], ly[3][BLOCK_SIZE], lz[3][BLOCK_SIZE];
+		float nx[BLOCK_SIZE], ny[BLOCK_SIZE], nz[BLOCK_SIZE];
+
+		for (uint32_t blockBegin = 0; blockBegin < count; blockBegin += BLOCK_SIZE)
+		{
+			uint32_t blockSize = std::min(BLOCK_SIZE, count - blockBegin);
+
+			for (uint32_t i = 0; i < blockSize; i++)
+			{
+				uint32_t face = faces ? faces[blockBegin + i] : firstFace + blockBegin + i;
+				uint32_t a = indices[face * 3 + 0];
+				uint32_t b = indices[face * 3 + 1];
+				uint32_t c = indices[face * 3 + 2];
+
+				faceIds[i] = face;
+				ax[i] = m_X[a]; ay[i] = m_Y[a]; az[i] = m_Z[a];
+				bx[i] = m_X[b]; by[i] = m_Y[b]; bz[i] = m_Z[b];
+				cx[i] = m_X[c]; cy[i] = m_Y[c]; cz[i] = m_Z[c];
+			}
+
+			// Branch free corner math, the three std::atan2 calls per face
+			// are library calls so the loop stays scalar
+			for (uint32_t i = 0; i < blockSize; i++)
+			{
+				float abx = bx[i] - ax[i], aby = by[i] - ay[i], abz = bz[i] - az[i];
+				float acx = cx[i] - ax[i], acy = cy[i] - ay[i], acz = cz[i] - az[i];
+				float bcx = cx[i] - bx[i], bcy = cy[i] - by[i], bcz = cz[i] - bz[i];
+
+				float abLength2 = abx * abx + aby * aby + abz * abz;
+				float acLength2 = acx * acx + acy * acy + acz * acz;
+				float bcLength2 = bcx * bcx + bcy * bcy + bcz * bcz;
+
+				// Cosines of the corner angles scaled by the edge lengths
+				float dotA = abx * acx + aby * acy + abz * acz;
+				float dotB = -(abx * bcx + aby * bcy + abz * bcz);
+				float dotC = acx * bcx + acy * bcy + acz * bcz;
+
+				float crossX = aby * acz - abz * acy;
+				float crossY = abz * acx - abx * acz;
+				float crossZ = abx * acy - aby * acx;
+
+				// Every corner shares the same sine term, twice the area
+				float twiceArea = std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ);
+				float invTwiceArea = twiceArea > 1e-20f ? 1.0f / twiceArea : 0.0f;
+
+				float cotA = dotA * invTwiceArea;
+				float cotB = dotB * invTwiceArea;
+				float cotC = dotC * invTwiceArea;
+
+				angles[0][i] = std::atan2(twiceArea, dotA);
+				angles[1][i] = std::atan2(twiceArea, dotB);
+				angles[2][i] = std::atan2(twiceArea, dotC);
+
+				// Voronoi areas for non-obtuse triangles, otherwise half
+				// of the area goes to the obtuse corner and a quarter to
+				// the others
+				float area = 0.5f * twiceArea;
+				bool obtuse = dotA < 0.0f || dotB < 0.0f || dotC < 0.0f;
+
+				float voronoiA = 0.125f * (acLength2 * cotB + abLength2 * cotC);
+				float voronoiB = 0.125f * (abLength2 * cotC + bcLength2 * cotA);
+				float voronoiC = 0.125f * (acLength2 * cotB + bcLength2 * cotA);
+
+				areas[0][i] = obtuse ? (dotA < 0.0f ? 0.5f : 0.25f) * area : voronoiA;
+				areas[1][i] = obtuse ? (dotB < 0.0f ? 0.5f : 0.25f) * area : voronoiB;
+				areas[2][i] = obtuse ? (dotC < 0.0f ? 0.5f : 0.25f) * area : voronoiC;
+
+				// Share of the face in sum (cot alpha + cot beta) (x_i - x_j)
+				// of each corner, the edge opposite to a corner uses its cotangent
+				lx[0][i] = -(cotC * abx + cotB * acx);
+				ly[0][i] = -(cotC * aby + cotB * acy);
+				lz[0][i] = -(cotC * abz + cotB * acz);
+
+				lx[1][i] = cotC * abx - cotA * bcx;
+				ly[1][i] = cotC * aby - cotA * bcy;
+				lz[1][i] = cotC * abz - cotA * bcz;
+
+				lx[2][i] = cotB * acx + cotA * bcx;
+				ly[2][i] = cotB * acy + cotA * bcy;
+				lz[2][i] = cotB * acz + cotA * bcz;
+
+				nx[i] = crossX;
+				ny[i] = crossY;
+				nz[i] = crossZ;
+			}
+
+			for (uint32_t i = 0; i < blockSize; i++)
+			{
+				uint32_t face = faceIds[i];
+
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					uint32_t corner = face * 3 + k;
+					m_CornerAngles[corner] = angles[k][i];
+					m_CornerAreas[corner] = areas[k][i];
+					m_CornerLaplacianX[corner] = lx[k][i];
+					m_CornerLaplacianY[corner] = ly[k][i];
+					m_CornerLaplacianZ[corner] = lz[k][i];
+				}
+
+				m_FaceNormalX[face] = nx[i];
+				m_FaceNormalY[face] = ny[i];
+				m_FaceNormalZ[face] = nz[i];
+			}
+		}
+	}
+
+	void DiscreteCurvature::GatherVertices(const HalfEdgeMesh& topology, const uint32_t* vertices, uint32_t firstVertex, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t vertex = vertices ? vertices[i] : firstVertex + i;
+
+			float angleSum = 0.0f, area = 0.0f;
+			float laplacianX = 0.0f, laplacianY = 0.0f, laplacianZ = 0.0f;
+			float normalX = 0.0f, normalY = 0.0f, normalZ = 0.0f;
+
+			for (uint32_t c = topology.GetCornerBegin(vertex); c < topology.GetCornerEnd(vertex); c++)
+			{
+				uint32_t corner = topology.GetCorner(c);
+				uint32_t face = topology.GetFace(corner);
+
+				angleSum += m_CornerAngles[corner];
+				area += m_CornerAreas[corner];
+				laplacianX += m_CornerLaplacianX[corner];
+				laplacianY += m_CornerLaplacianY[corner];
+				laplacianZ += m_CornerLaplacianZ[corner];
+				normalX += m_FaceNormalX[face];
+				normalY += m_FaceNormalY[face];
+				normalZ += m_FaceNormalZ[face];
+			}
+
+			float fullAngle = topology.IsBoundaryVertex(vertex) ? glm::pi<float>() : glm::two_pi<float>();
+			float invArea = area > 0.0f ? 1.0f / area : 0.0f;
+
+			float gaussian = (fullAngle - angleSum) * invArea;
+
+			// The summed vectors divided by 2A are the mean curvature
+			// normal 2Hn
+			float laplacianLength = std::sqrt(laplacianX * laplacianX + laplacianY * laplacianY + laplacianZ * laplacianZ);
+			float mean = 0.25f * laplacianLength * invArea;
+			if (laplacianX * normalX + laplacianY * normalY + laplacianZ * normalZ < 0.0f)
+				mean = -mean;
+
+			// H^2 - K can get slightly negative from discretization
+			float discriminant = std::sqrt(std::max(mean * mean - gaussian, 0.0f));
+
+			m_GaussianCurvatures[vertex] = gaussian;
+			m_MeanCurvatures[vertex] = mean;
+			m_MaxCurvatures[vertex] = mean + discriminant;
+			m_MinCurvatures[vertex] = mean - discriminant;
+			m_VoronoiAreas[vertex] = area;
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+
+namespace GP
+{
+	// Discrete curvatures of a triangle mesh (Meyer et al. 2003). One pass
+	// over the faces computes the angle, the mixed Voronoi area and the
+	// cotangent weighted edge vectors of every corner, a second pass over
+	// the vertices sums the corners around each vertex. Corner values are
+	// written to their own slot so no pass needs locks or atomics, and
+	// they are kept so a partial update only touches the faces that moved.
+	class DiscreteCurvature
+	{
+	public:
+		DiscreteCurvature() {}
+
+		// Recomputes every face and vertex
+		void Compute(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices);
+
+		// Recomputes the given faces and sums the given vertices again.
+		// faces has to contain every face with a moved corner and
+		// vertices every corner of those faces
+		void Update(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices,
+			        const std::vector<uint32_t>& faces, const std::vector<uint32_t>& updatedVertices);
+
+		// Angle deficit divided by the mixed area, boundary vertices
+		// use pi instead of 2 pi
+		const std::vector<float>& GetGaussianCurvatures() const { return m_GaussianCurvatures; }
+
+		// Half the length of the cotangent Laplacian of the position,
+		// positive where the surface bends away from its normal
+		const std::vector<float>& GetMeanCurvatures() const { return m_MeanCurvatures; }
+
+		const std::vector<float>& GetMaxCurvatures() const { return m_MaxCurvatures; }
+		const std::vector<float>& GetMinCurvatures() const { return m_MinCurvatures; }
+
+		// Mixed Voronoi area of each vertex, the obtuse triangle fallback
+		// keeps the areas summing up to the surface area
+		const std::vector<float>& GetVoronoiAreas() const { return m_VoronoiAreas; }
+
+	private:
+		void Resize(const HalfEdgeMesh& topology);
+
+		void LoadPositions(const std::vector<glm::vec3>& vertices, uint32_t begin, uint32_t end);
+		void LoadPositions(const std::vector<glm::vec3>& vertices, const uint32_t* list, uint32_t count);
+
+		// Corner values of faces[0, count), faces is null for a range
+		// starting at firstFace
+		void ComputeFaces(const HalfEdgeMesh& topology, const uint32_t* faces, uint32_t firstFace, uint32_t count);
+		void GatherVertices(const HalfEdgeMesh& topology, const uint32_t* vertices, uint32_t firstVertex, uint32_t count);
+
+	private:
+		// Positions as separate coordinate arrays for the face kernels
+		std::vector<float> m_X;
+		std::vector<float> m_Y;
+		std::vector<float> m_Z;
+
+		// Per corner (half-edge) values of the face pass
+		std::vector<float> m_CornerAngles;
+		std::vector<float> m_CornerAreas;
+		std::vector<float> m_CornerLaplacianX;
+		std::vector<float> m_CornerLaplacianY;
+		std::vector<float> m_CornerLaplacianZ;
+
+		// Area weighted face normals, only their direction is used for
+		// the sign of the mean curvature
+		std::vector<float> m_FaceNormalX;
+		std::vector<float> m_FaceNormalY;
+		std::vector<float> m_FaceNormalZ;
+
+		std::vector<float> m_GaussianCurvatures;
+		std::vector<float> m_MeanCurvatures;
+		std::vector<float> m_MaxCurvatures;
+		std::vector<float> m_MinCurvatures;
+		std::vector<float> m_VoronoiAreas;
+	};
+}
@@ -0,0 +1,182 @@
+#include <Precomp.h>
+#include <MeshOperations/DistanceMatrixFile.h>
+
+#include <glm/gtc/packing.hpp>
+
+namespace GP
+{
+	uint64_t DistanceMatrixHeader::GetRowOffset(uint32_t row) const
+	{
+		uint64_t i = row;
+		uint64_t n = vertexCount;
+
+		// Rows before i hold n, n - 1, ..., n - i + 1 elements
+		if (storage == DistanceMatrixStorage::UPPER_TRIANGLE)
+			return i * n - (i * (i - 1)) / 2;
+
+		return i * n;
+	}
+
+	uint64_t DistanceMatrixHeader::GetRowLength(uint32_t row) const
+	{
+		if (storage == DistanceMatrixStorage::UPPER_TRIANGLE)
+			return vertexCount - row;
+
+		return vertexCount;
+	}
+
+	uint64_t DistanceMatrixHeader::GetDataSize() const
+	{
+		uint64_t n = vertexCount;
+		uint64_t count = storage == DistanceMatrixStorage::UPPER_TRIANGLE ? n * (n + 1) / 2 : n * n;
+
+		return count * GetElementSize();
+	}
+
+	DistanceMatrixWriter::DistanceMatrixWriter(const std::filesystem::path& path, uint32_t vertexCount,
+		                                       DistanceMatrixPrecision precision, DistanceMatrixStorage storage)
+	{
+		m_Header.vertexCount = vertexCount;
+		m_Header.precision = precision;
+		m_Header.storage = storage;
+
+		m_File.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_File.is_open())
+		{
+			GP_ERROR("Could not open {0} for writing", path.string());
+			return;
+		}
+
+		m_File.write((const char*)&m_Header, sizeof(DistanceMatrixHeader));
+
+		// Extend the file to its final size so every row can be
+		// written with a single seek
+		uint64_t dataSize = m_Header.GetDataSize();
+		if (dataSize > 0)
+		{
+			m_File.seekp(sizeof(DistanceMatrixHeader) + dataSize - 1);
+			m_File.put(0);
+		}
+	}
+
+	DistanceMatrixWriter::~DistanceMatrixWriter()
+	{
+		Close();
+	}
+
+	bool DistanceMatrixWriter::WriteRow(uint32_t row, const float* distances)
+	{
+		uint64_t first = m_Header.vertexCount - m_Header.GetRowLength(row);
+		uint64_t length = m_Header.GetRowLength(row);
+		uint64_t position = sizeof(DistanceMatrixHeader) + m_Header.GetRowOffset(row) * m_Header.GetElementSize();
+
+		// Conversion happens outside of the lock, only the write
+		// itself is serialized
+		const char* data = (const char*)(distances + first);
+		thread_local std::vector<uint16_t> halfRow;
+		if (m_Header.precision == DistanceMatrixPrecision::FLOAT16)
+		{
+			halfRow.resize(length);
+			for (uint64_t j = 0; j < length; j++)
+				halfRow[j] = glm::packHalf1x16(distances[first + j]);
+
+			data = (const char*)halfRow.data();
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_File.seekp(position);
+		m_File.write(data, length * m_Header.GetElementSize());
+		return m_File.good();
+	}
+
+	bool DistanceMatrixWriter::Close()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_File.is_open())
+			return false;
+
+		// Stream errors are sticky, a failed header or row write shows up here
+		m_File.flush();
+		bool written = m_File.good();
+		m_File.close();
+		return written && !m_File.fail();
+	}
+
+	DistanceMatrixReader::DistanceMatrixReader(const std::filesystem::path& path)
+	{
+		m_File = MappedFile::Create(path);
+		if (!m_File->IsOpen() || m_File->GetSize() < sizeof(DistanceMatrixHeader))
+			return;
+
+		std::memcpy(&m_Header, m_File->GetData(), sizeof(DistanceMatrixHeader));
+
+		DistanceMatrixHeader reference;
+		if (std::memcmp(m_Header.magic, reference.magic, sizeof(reference.magic)) != 0 ||
+			m_Header.version != reference.version)
+		{
+			GP_ERROR("{0} is not a distance matrix file", path.string());
+			return;
+		}
+
+		if (m_File->GetSize() < sizeof(DistanceMatrixHeader) + m_Header.GetDataSize())
+		{
+			GP_ERROR("Distance matrix file {0} is truncated", path.string());
+			return;
+		}
+
+		m_Data = m_File->GetData() + sizeof(DistanceMatrixHeader);
+	}
+
+	Ref<DistanceMatrixReader> DistanceMatrixReader::Create(const std::filesystem::path& path)
+	{
+		return std::make_shared<DistanceMatrixReader>(path);
+	}
+
+	float DistanceMatrixReader::GetElement(uint64_t index) const
+	{
+		if (m_Header.precision == DistanceMatrixPrecision::FLOAT16)
+		{
+			uint16_t value;
+			std::memcpy(&value, m_Data + index * 2, sizeof(uint16_t));
+			return glm::unpackHalf1x16(value);
+		}
+
+		float value;
+		std::memcpy(&value, m_Data + index * 4, sizeof(float));
+		return value;
+	}
+
+	float DistanceMatrixReader::GetDistance(uint32_t i, uint32_t j) const
+	{
+		if (m_Header.storage == DistanceMatrixStorage::UPPER_TRIANGLE)
+		{
+			if (i > j)
+				std::swap(i, j);
+
+			return GetElement(m_Header.GetRowOffset(i) + (j - i));
+		}
+
+		return GetElement(m_Header.GetRowOffset(i) + j);
+	}
+
+	void DistanceMatrixReader::ReadRow(uint32_t row, float* outDistances) const
+	{
+		uint32_t n = m_Header.vertexCount;
+
+		if (m_Header.storage == DistanceMatrixStorage::UPPER_TRIANGLE)
+		{
+			for (uint32_t j = 0; j < row; j++)
+				outDistances[j] = GetDistance(j, row);
+
+			uint64_t offset = m_Header.GetRowOffset(row);
+			for (uint32_t j = row; j < n; j++)
+				outDistances[j] = GetElement(offset + (j - row));
+
+			return;
+		}
+
+		uint64_t offset = m_Header.GetRowOffset(row);
+		for (uint32_t j = 0; j < n; j++)
+			outDistances[j] = GetElement(offset + j);
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <fstream>
+#include <filesystem>
+
+#include <GeoProcess/System/CoreSystem/Core.h>
+#include <GeoProcess/System/ResourceSystem/MappedFile.h>
+
+namespace GP
+{
+	enum class DistanceMatrixPrecision : uint32_t
+	{
+		FLOAT32 = 0,
+		FLOAT16 = 1
+	};
+
+	enum class DistanceMatrixStorage : uint32_t
+	{
+		// Every row holds all N entries
+		FULL = 0,
+		// Row i holds only the entries j >= i, the matrix is symmetric
+		UPPER_TRIANGLE = 1
+	};
+
+	struct DistanceMatrixSpecs
+	{
+		bool binary = true;
+		DistanceMatrixPrecision precision = DistanceMatrixPrecision::FLOAT32;
+		DistanceMatrixStorage storage = DistanceMatrixStorage::UPPER_TRIANGLE;
+	};
+
+	// Binary distance matrix (.gdm) layout: a fixed 32 byte header followed
+	// by the rows in order, without any padding between them.
+	struct DistanceMatrixHeader
+	{
+		char magic[4] = { 'G', 'D', 'M', '1' };
+		uint32_t version = 1;
+		uint32_t vertexCount = 0;
+		DistanceMatrixPrecision precision = DistanceMatrixPrecision::FLOAT32;
+		DistanceMatrixStorage storage = DistanceMatrixStorage::FULL;
+		uint32_t reserved[3] = { 0, 0, 0 };
+
+		uint64_t GetElementSize() const { return precision == DistanceMatrixPrecision::FLOAT16 ? 2 : 4; }
+
+		// Index of the first stored element of a row
+		uint64_t GetRowOffset(uint32_t row) const;
+		uint64_t GetRowLength(uint32_t row) const;
+		uint64_t GetDataSize() const;
+	};
+
+	// Writes rows of the matrix as they are produced. Rows may arrive in
+	// any order and from any thread, each one is written at its final
+	// position so the full matrix never has to be kept in memory.
+	class DistanceMatrixWriter
+	{
+	public:
+		DistanceMatrixWriter(const std::filesystem::path& path, uint32_t vertexCount,
+			                 DistanceMatrixPrecision precision, DistanceMatrixStorage storage);
+		~DistanceMatrixWriter();
+
+		bool IsOpen() const { return m_File.is_open(); }
+
+		// distances holds all N values of the row, only the stored part
+		// is written. Returns false once any write to the file failed
+		bool WriteRow(uint32_t row, const float* distances);
+
+		// Flushes the file, false when any earlier write or the flush failed
+		bool Close();
+
+	private:
+		DistanceMatrixHeader m_Header;
+		std::ofstream m_File;
+		std::mutex m_Mutex;
+	};
+
+	// Reads a .gdm file through a memory mapping, distances are decoded
+	// on access so opening a matrix costs nothing regardless of its size.
+	class DistanceMatrixReader
+	{
+	public:
+		DistanceMatrixReader(const std::filesystem::path& path);
+
+		static Ref<DistanceMatrixReader> Create(const std::filesystem::path& path);
+
+		bool IsValid() const { return m_Data != nullptr; }
+
+		uint32_t GetVertexCount() const { return m_Header.vertexCount; }
+		const DistanceMatrixHeader& GetHeader() const { return m_Header; }
+
+		float GetDistance(uint32_t i, uint32_t j) const;
+
+		// Fills all N entries of a row, for upper triangle storage the
+		// part below the diagonal is gathered from the earlier rows
+		void ReadRow(uint32_t row, float* outDistances) const;
+
+	private:
+		float GetElement(uint64_t index) const;
+
+	private:
+		DistanceMatrixHeader m_Header;
+		Ref<MappedFile> m_File;
+		const uint8_t* m_Data = nullptr;
+	};
+}
@@ -2,8 +2,11 @@
 #include <MeshOperations/EditorMesh.h>
 #include <GeoProcess/System/ResourceSystem/ResourceManager.h>
 #include <GeoProcess/System/Profiling/Timer.h>
+#include <GeoProcess/System/Utils/ParallelFor.h>
 #include <GeoProcess/System/Geometry/Icosphere.h>
 
+#include <numeric>
+
 #include <glad/glad.h>
 
 #include <GeoProcess/System/RenderSystem/RenderCommand.h>
@@ -108,8 +111,10 @@ namespace GP
 		m_Sphere = Icosphere::Create(0.8f, 1, false);
 		BuildVertices();
 
-		m_CoreSize = std::thread::hardware_concurrency();
+		m_CoreSize = std::max(1u, std::thread::hardware_concurrency());
 		m_Count = 0;
+
+		LoadGDM();
 	}
 
 	EditorMesh::EditorMesh(std::string name, const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
@@ -124,7 +129,7 @@ namespace GP
 		m_Indices = indices;
 		BuildVerticesNoMesh();
 
-		m_CoreSize = std::thread::hardware_concurrency();
+		m_CoreSize = std::max(1u, std::thread::hardware_concurrency());
 		m_Count = 0;
 	}
 
@@ -140,32 +145,307 @@ namespace GP
 
 	void EditorMesh::UpdateVertices(const std::vector<glm::vec3>& newVertices)
 	{
+		if (newVertices.size() != m_Vertices.size())
+		{
+			GP_ERROR("UpdateVertices got {0} vertices for a mesh with {1}", newVertices.size(), m_Vertices.size());
+			return;
+		}
+
+		std::vector<uint32_t> moved;
+		for (uint32_t i = 0; i < m_Vertices.size(); i++)
+		{
+			if (newVertices[i] != m_Vertices[i])
+				moved.push_back(i);
+		}
+
+		if (moved.empty())
+			return;
+
 		m_Vertices = newVertices;
 
+		MarkVerticesMoved(moved);
+		UpdateDerivedData();
+	}
+
+	void EditorMesh::UpdateAllVertices(const std::function<void(glm::vec3*)>& writeVertices)
+	{
+		writeVertices(m_Vertices.data());
+
+		MarkDirty(MeshData::POSITIONS);
+		m_AllVerticesMoved = true;
 
-		// Calculate smooth normals
-		// CalculateSmoothNormals();
+		UpdateDerivedData();
+	}
 
-		SetupFlatElements();
-		SetupTangentBitangents(false);
-		//CalculateColors();
-		SetupArrayBufferForColoring(m_AGDArrayBuffer, m_AverageGeodesicDistanceColors);
-		SetupArrayBufferForColoring(m_GCArrayBuffer, m_GaussianCurvatureColors);
-		SetupArrayBufferForFlatColoring(m_QualityArrayBuffer, m_QualityColors);
+	void EditorMesh::SetRenderMode(RENDERMODE mode)
+	{
+		m_RenderSpecs.renderMode = mode;
 
-		// We register array buffers to the mesh for coloring
-		SetupMeshForColoring(m_AGDVertexArray, m_AGDVertexBuffer,
-			m_AGDArrayBuffer, m_AGDIndexBuffer);
+		// Brings the data of the new mode up to date if it was deferred
+		UpdateDerivedData();
+	}
 
-		SetupMeshForColoring(m_GCVertexArray, m_GCVertexBuffer,
-			m_GCArrayBuffer, m_GCIndexBuffer);
+	const DiscreteCurvature& EditorMesh::GetCurvature()
+	{
+		UpdateDerivedData(MeshData::CURVATURE);
+		return m_Curvature;
+	}
+
+	void EditorMesh::MarkDirty(MeshData data)
+	{
+		// Direct dependents of each piece of data. They always come later
+		// in MeshData, so one pass in this order marks the whole chain
+		static const std::pair<MeshData, uint32_t> dependents[] =
+		{
+			{ MeshData::TOPOLOGY,      (uint32_t)MeshData::ALL },
+			{ MeshData::EDGE_LENGTHS,  (uint32_t)MeshData::GEODESICS },
+			{ MeshData::GEODESICS,     (uint32_t)MeshData::AGD },
+			{ MeshData::NORMALS,       (uint32_t)MeshData::SURFACE_BUFFER },
+			{ MeshData::CURVATURE,     (uint32_t)MeshData::GC_BUFFER },
+			{ MeshData::QUALITY,       (uint32_t)MeshData::QUALITY_BUFFER },
+			{ MeshData::SAMPLES,       (uint32_t)MeshData::AGD },
+			{ MeshData::AGD,           (uint32_t)MeshData::AGD_BUFFER }
+		};
+
+		uint32_t dirty = (uint32_t)data;
+		for (const auto& [flag, flags] : dependents)
+		{
+			if (dirty & (uint32_t)flag)
+				dirty |= flags;
+		}
 
-		SetupMeshForFlatColoring(m_QualityVertexArray, m_QualityVertexBuffer,
-			m_QualityArrayBuffer, m_QualityIndexBuffer);
+		if (dirty & (uint32_t)MeshData::TOPOLOGY)
+			m_AllVerticesMoved = true;
 
-		// We setup and register array buffers for drawing normally
-		SetupArrayBuffer();
-		SetupMesh();
+		m_DirtyData |= dirty;
+	}
+
+	void EditorMesh::MarkVerticesMoved(const std::vector<uint32_t>& vertices)
+	{
+		MarkDirty(MeshData::POSITIONS);
+
+		if (m_AllVerticesMoved)
+			return;
+
+		m_MovedFlags.resize(m_Vertices.size(), 0);
+
+		for (uint32_t vertex : vertices)
+		{
+			if (!m_MovedFlags[vertex])
+			{
+				m_MovedFlags[vertex] = 1;
+				m_MovedVertices.push_back(vertex);
+			}
+		}
+
+		// Past this point walking one-rings costs more than
+		// recomputing the whole mesh
+		if (m_MovedVertices.size() > m_Vertices.size() / 4)
+		{
+			for (uint32_t vertex : m_MovedVertices)
+				m_MovedFlags[vertex] = 0;
+
+			m_MovedVertices.clear();
+			m_AllVerticesMoved = true;
+		}
+	}
+
+	void EditorMesh::CollectAffectedElements(std::vector<uint32_t>& vertices, std::vector<uint32_t>& faces) const
+	{
+		vertices.clear();
+		faces.clear();
+
+		if (m_AllVerticesMoved)
+		{
+			vertices.resize(m_Vertices.size());
+			std::iota(vertices.begin(), vertices.end(), 0);
+
+			faces.resize(m_Triangles.size());
+			std::iota(faces.begin(), faces.end(), 0);
+			return;
+		}
+
+		const HalfEdgeMesh& topology = *m_HalfEdgeMesh;
+
+		for (uint32_t vertex : m_MovedVertices)
+		{
+			for (uint32_t c = topology.GetCornerBegin(vertex); c < topology.GetCornerEnd(vertex); c++)
+				faces.push_back(topology.GetFace(topology.GetCorner(c)));
+		}
+
+		std::sort(faces.begin(), faces.end());
+		faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+
+		for (uint32_t face : faces)
+		{
+			vertices.push_back(m_Triangles[face].idx1);
+			vertices.push_back(m_Triangles[face].idx2);
+			vertices.push_back(m_Triangles[face].idx3);
+		}
+
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+	}
+
+	uint32_t EditorMesh::GetDisplayedData() const
+	{
+		switch (m_RenderSpecs.renderMode)
+		{
+			case(RENDERMODE::AGD):     return (uint32_t)MeshData::AGD | (uint32_t)MeshData::AGD_BUFFER;
+			case(RENDERMODE::GC):      return (uint32_t)MeshData::CURVATURE | (uint32_t)MeshData::GC_BUFFER;
+			case(RENDERMODE::QUALITY): return (uint32_t)MeshData::QUALITY | (uint32_t)MeshData::QUALITY_BUFFER;
+			default:                   return 0;
+		}
+	}
+
+	void EditorMesh::UpdateDerivedData()
+	{
+		UpdateDerivedData(0);
+	}
+
+	void EditorMesh::UpdateDerivedData(MeshData required)
+	{
+		UpdateDerivedData((uint32_t)required);
+	}
+
+	void EditorMesh::UpdateDerivedData(uint32_t required)
+	{
+		PollAverageGeodesicDistances();
+
+		// Coloring data of the modes that are not drawn waits until one of
+		// them is selected. A new topology builds everything, the vertex
+		// array needs every stream once
+		uint32_t deferred = 0;
+		if (!IsDirty(MeshData::TOPOLOGY))
+			deferred = m_DirtyData & (uint32_t)MeshData::COLORING & ~(GetDisplayedData() | required);
+
+		if ((m_DirtyData & ~deferred) == 0)
+			return;
+
+		m_DirtyData &= ~deferred;
+
+		Timer t;
+
+		if (IsDirty(MeshData::TOPOLOGY))
+		{
+			// We first setup the triangles each triangle will
+			// hold 3 indices for vertices in CCW direction and
+			// the indices follow the order of m_Indices
+			SetupTriangles();
+
+			m_Smoother.reset();
+
+			// Half-edge topology gives constant time one-ring and
+			// vertex to face queries for normals and curvature
+			SetupHalfEdgeMesh();
+
+			// Node table is used for keeping track of vertices while running
+			// dijkstra's shortest path algorithm, it is used for geodesic distances
+			SetupNodeTable();
+
+			// Adjacency is a compressed sparse row structure which holds the
+			// indices of vertices that are neighbors to a specific vertex and
+			// the edge lengths to them, it is used for coloring computations
+			// and also geodesic distances
+			SetupAdjacency();
+		}
+		else if (IsDirty(MeshData::EDGE_LENGTHS))
+		{
+			// Topology stays the same, only edge lengths change
+			m_Adjacency.UpdateEdgeLengths(m_Vertices);
+
+			// IMPLICIT smoothing keeps the operators of the positions it was
+			// built from, vertices moved by anything else invalidate them
+			if (m_Smoother && !m_SmootherMovedVertices)
+				m_Smoother->ResetOperator();
+		}
+
+		// An exported matrix, the solvers and the eigenbasis describe
+		// the old shape
+		if (IsDirty(MeshData::GEODESICS))
+		{
+			m_DistanceMatrix.reset();
+			m_ExactSolver.reset();
+			m_HeatSolver.reset();
+			m_SpectralBasis.reset();
+		}
+
+		std::vector<uint32_t> vertices, faces;
+		CollectAffectedElements(vertices, faces);
+
+		if (IsDirty(MeshData::NORMALS))
+		{
+			if (m_AllVerticesMoved)
+				CalculateSmoothNormals();
+			else
+				CalculateSmoothNormals(vertices);
+		}
+
+		// Gaussian curvature and triangle quality are local, only the values
+		// around moved vertices change. Average geodesic distance is global
+		// so it is recomputed, but the samples are kept while the topology
+		// stays the same.
+		if (IsDirty(MeshData::CURVATURE))
+		{
+			if (m_AllVerticesMoved)
+				m_Curvature.Compute(*m_HalfEdgeMesh, m_Vertices);
+			else
+				m_Curvature.Update(*m_HalfEdgeMesh, m_Vertices, faces, vertices);
+		}
+
+		if (IsDirty(MeshData::QUALITY))
+			CalculateTriangleQualities(faces);
+
+		if (IsDirty(MeshData::SAMPLES))
+			m_SamplePoints = SampleNPoints(5);
+
+		if (IsDirty(MeshData::AGD))
+			CalculateAverageGeodesicDistances();
+
+		// The index buffer and the colormap only change with the topology
+		if (IsDirty(MeshData::TOPOLOGY))
+		{
+			if (m_IndexBuffer)
+				m_IndexBuffer->SetData(&m_Indices[0], m_Indices.size());
+			else
+				m_IndexBuffer = IndexBuffer::Create(&m_Indices[0], m_Indices.size());
+
+			SetupColormap();
+		}
+
+		// Scalar streams are a raw float per vertex (or face) instead of
+		// a full colored copy of the mesh, they are created once and
+		// rewritten in place afterwards
+		if (IsDirty(MeshData::AGD_BUFFER))
+			SetupScalarBuffer(m_AGDScalarBuffer, m_AGDRange, m_AverageGeodesicDistances);
+
+		if (IsDirty(MeshData::GC_BUFFER))
+			SetupScalarBuffer(m_GCScalarBuffer, m_GCRange, m_Curvature.GetGaussianCurvatures());
+
+		if (IsDirty(MeshData::QUALITY_BUFFER))
+			SetupQualityScalars();
+
+		// Positions and normals shared by every render mode
+		if (IsDirty(MeshData::SURFACE_BUFFER))
+		{
+			SetupArrayBuffer();
+			SetupMesh();
+		}
+
+		GP_TRACE("Updated mesh data of {0} around {1} vertices in {2} ms", m_MainMesh.Name,
+			vertices.size(), t.ElapsedMilliseconds());
+
+		m_DirtyData = deferred;
+
+		// Deferred data is updated around every vertex moved since
+		if (deferred != 0)
+			return;
+
+		for (uint32_t vertex : m_MovedVertices)
+			m_MovedFlags[vertex] = 0;
+
+		m_MovedVertices.clear();
+		m_AllVerticesMoved = false;
 	}
 
 	Ref<Mesh> EditorMesh::GetMainMesh()
@@ -189,6 +469,14 @@ namespace GP
 			return "Min Heap";
 		else if (m_GeodesicDistanceCalcMethod == 1)
 			return "Array";
+		else if (m_GeodesicDistanceCalcMethod == 2)
+			return "Indexed Heap";
+		else if (m_GeodesicDistanceCalcMethod == 3)
+			return "Exact (ICH)";
+		else if (m_GeodesicDistanceCalcMethod == 4)
+			return "Heat Method";
+
+		return std::string();
 	}
 
 	std::string EditorMesh::GiveRenderMethodName()
@@ -209,6 +497,10 @@ namespace GP
 		{
 			return "Triangle Quality";
 		}
+		else if (m_RenderSpecs.renderMode == RENDERMODE::SCALAR)
+		{
+			return "Scalar Field";
+		}
 		else if (m_RenderSpecs.renderMode == RENDERMODE::SMOOTH)
 		{
 			return "Smooth";
@@ -227,63 +519,13 @@ namespace GP
 		m_TexCoords = m_MainMesh.Mesh->GetTexCoords();
 		m_Indices = m_MainMesh.Mesh->GetIndicesVector();
 
-		// We first setup the triangles each triangle will
-		// hold 3 indices for vertices in CCW direction and
-		// the indices follow the order of m_Indices
-		SetupTriangles();
-
-		// We also need a flat shaded version because for quality
-		// coloring, we need to color individual triangles, I might
-		// change this to something better in the future If I can
-		// find one but this is the solution now
-		SetupFlatElements();
-
-		// Node table is used for keeping track of vertices while running
-		// dijkstra's shortest path algorithm, it is used for geodesic distances
-		SetupNodeTable();
-		SetupNodeTableExport();
+		// Everything else is derived from these, the normals of the
+		// model are used as they are until its vertices move
+		m_DirtyData = 0;
+		MarkDirty(MeshData::TOPOLOGY);
+		m_DirtyData &= ~(uint32_t)MeshData::NORMALS;
 
-		// Adjacency map is an unordered map (hash table) which holds the
-		// indices of vertices that are neighbors to a specific vertex
-		// it is used for coloring computations and also geodesic distances
-		SetupAdjacencyMap();
-
-		// Tangents and bitangents are calculated from normals, texture coordinates
-		// and vertex positions, in our case we might not need for this because we
-		// do not deal with textures in geometry processing course
-		SetupTangentBitangents(false);
-
-		
-		// We compute colors of each vertices using Average Geodesic Distances and
-		// gaussian curvature. We also compute colors for each triangle's quality
-		// all these values for Average Geodesic Distance, Gaussian Curvature and
-		// Triangle's quality are between 0 and 1 and the colors assigned to them
-		// are between red and blue (red - green - blue). For getting color gradient
-		// I have used hsv color space instead of rgb.
-		CalculateColors();
-
-		// After calculating the colors, we setup array buffer for drawing with color
-		// there are separate vertex array objects and vertex buffer objects because
-		// I did not want to fill the buffers everytime I change a drawing mode
-		// Quality array buffer uses flat coloring because we want to color each
-		// triangle
-		SetupArrayBufferForColoring(m_AGDArrayBuffer, m_AverageGeodesicDistanceColors);
-		SetupArrayBufferForColoring(m_GCArrayBuffer, m_GaussianCurvatureColors);
-		SetupArrayBufferForFlatColoring(m_QualityArrayBuffer, m_QualityColors);
-
-		// We register array buffers to the mesh for coloring
-		SetupMeshForColoring(m_AGDVertexArray, m_AGDVertexBuffer,
-							 m_AGDArrayBuffer, m_AGDIndexBuffer);
-
-		SetupMeshForColoring(m_GCVertexArray, m_GCVertexBuffer,
-							 m_GCArrayBuffer, m_GCIndexBuffer);
-
-		SetupMeshForFlatColoring(m_QualityVertexArray, m_QualityVertexBuffer,
-								 m_QualityArrayBuffer, m_QualityIndexBuffer);
-
-		// We setup and register array buffers for drawing normally
-		SetupArrayBuffer();
-		SetupMesh();
+		UpdateDerivedData();
 
 		 // These will be separated as different functions
 		//ComputeNxNGeodesicDistanceMatrix();
@@ -295,71 +537,12 @@ namespace GP
 	// mesh from set of vertices and indices we get from a database
 	void EditorMesh::BuildVerticesNoMesh()
 	{
-
 		m_TexCoords.resize(m_Vertices.size(), glm::vec2(0.0f, 0.0f));
-		// We first setup the triangles each triangle will
-		// hold 3 indices for vertices in CCW direction and
-		// the indices follow the order of m_Indices
-		SetupTriangles();
-
-
-		// We also need a flat shaded version because for quality
-		// coloring, we need to color individual triangles, I might
-		// change this to something better in the future If I can
-		// find one but this is the solution now
-		SetupFlatElements();
-
-		// Node table is used for keeping track of vertices while running
-		// dijkstra's shortest path algorithm, it is used for geodesic distances
-		SetupNodeTable();
-		SetupNodeTableExport();
-
-		// Adjacency map is an unordered map (hash table) which holds the
-		// indices of vertices that are neighbors to a specific vertex
-		// it is used for coloring computations and also geodesic distances
-		SetupAdjacencyMap();
-
-
-		// Calculate smooth normals
-		CalculateSmoothNormals();
-		std::cout << m_Normals.size() << std::endl;
-
-		// Tangents and bitangents are calculated from normals, texture coordinates
-		// and vertex positions, in our case we might not need for this because we
-		// do not deal with textures in geometry processing course
-		SetupTangentBitangents(false);
-
-
-		// We compute colors of each vertices using Average Geodesic Distances and
-		// gaussian curvature. We also compute colors for each triangle's quality
-		// all these values for Average Geodesic Distance, Gaussian Curvature and
-		// Triangle's quality are between 0 and 1 and the colors assigned to them
-		// are between red and blue (red - green - blue). For getting color gradient
-		// I have used hsv color space instead of rgb.
-		CalculateColors();
-
-		// After calculating the colors, we setup array buffer for drawing with color
-		// there are separate vertex array objects and vertex buffer objects because
-		// I did not want to fill the buffers everytime I change a drawing mode
-		// Quality array buffer uses flat coloring because we want to color each
-		// triangle
-		SetupArrayBufferForColoring(m_AGDArrayBuffer, m_AverageGeodesicDistanceColors);
-		SetupArrayBufferForColoring(m_GCArrayBuffer, m_GaussianCurvatureColors);
-		SetupArrayBufferForFlatColoring(m_QualityArrayBuffer, m_QualityColors);
-
-		// We register array buffers to the mesh for coloring
-		SetupMeshForColoring(m_AGDVertexArray, m_AGDVertexBuffer,
-			m_AGDArrayBuffer, m_AGDIndexBuffer);
-
-		SetupMeshForColoring(m_GCVertexArray, m_GCVertexBuffer,
-			m_GCArrayBuffer, m_GCIndexBuffer);
-
-		SetupMeshForFlatColoring(m_QualityVertexArray, m_QualityVertexBuffer,
-			m_QualityArrayBuffer, m_QualityIndexBuffer);
-
-		// We setup and register array buffers for drawing normally
-		SetupArrayBuffer();
-		SetupMesh();
+
+		m_DirtyData = 0;
+		MarkDirty(MeshData::TOPOLOGY);
+
+		UpdateDerivedData();
 
 		// These will be separated as different functions
 	   //ComputeNxNGeodesicDistanceMatrix();
@@ -384,17 +567,37 @@ namespace GP
 
 	void EditorMesh::SmoothingFunction()
 	{
-		std::unordered_map<uint32_t,glm::vec3> displacementMap;
+		if (m_SmoothingSpecs.mode != SmoothingMode::EXPLICIT)
+		{
+			if (!m_Smoother)
+				m_Smoother = ImplicitSmoother::Create(*m_HalfEdgeMesh);
+
+			// MEAN_CURVATURE_FLOW can fail after some steps were taken,
+			// the mesh only changes when every step succeeded
+			std::vector<glm::vec3> smoothed = m_Vertices;
+			if (!m_Smoother->Smooth(smoothed, m_SmoothingSpecs))
+				return;
+
+			m_Vertices.swap(smoothed);
+
+			m_AllVerticesMoved = true;
+			MarkDirty(MeshData::POSITIONS);
 
-		for (uint32_t i = 0; i < m_Indices.size(); i++)
-			displacementMap[i] = glm::vec3(0.0f, 0.0f, 0.0f);
+			m_SmootherMovedVertices = true;
+			UpdateDerivedData();
+			m_SmootherMovedVertices = false;
+			return;
+		}
+
+		std::vector<glm::vec3> displacementMap(m_Vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
 
 		for (uint32_t i = 0; i < m_Vertices.size(); i++)
 		{
 			glm::vec3 center = m_Vertices[i];
 
-			for (auto neighbor : m_AdjacencyMap[i])
+			for (uint32_t e = m_Adjacency.Begin(i); e < m_Adjacency.End(i); e++)
 			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
 				glm::vec3 neighborPos = m_Vertices[neighbor];
 				glm::vec3 dir = glm::normalize(center - neighborPos);
 				displacementMap[neighbor] += dir * m_SmootingFactor;
@@ -406,195 +609,158 @@ namespace GP
 			m_Vertices[i] += displacementMap[i];
 		}
 
-
-		SetupTriangles();
-		SetupFlatElements();
-		SetupNodeTable();
-		SetupNodeTableExport();
-		SetupAdjacencyMap();
-		SetupTangentBitangents(false);
-		CalculateColors();
-		SetupArrayBufferForColoring(m_AGDArrayBuffer, m_AverageGeodesicDistanceColors);
-		SetupArrayBufferForColoring(m_GCArrayBuffer, m_GaussianCurvatureColors);
-		SetupArrayBufferForFlatColoring(m_QualityArrayBuffer, m_QualityColors);
-		SetupMeshForColoring(m_AGDVertexArray, m_AGDVertexBuffer,
-			m_AGDArrayBuffer, m_AGDIndexBuffer);
-		SetupMeshForColoring(m_GCVertexArray, m_GCVertexBuffer,
-			m_GCArrayBuffer, m_GCIndexBuffer);
-		SetupMeshForFlatColoring(m_QualityVertexArray, m_QualityVertexBuffer,
-			m_QualityArrayBuffer, m_QualityIndexBuffer);
-		SetupArrayBuffer();
-		SetupMesh();
-
+		// Every vertex moves but the topology stays the same
+		m_AllVerticesMoved = true;
+		MarkDirty(MeshData::POSITIONS);
+		UpdateDerivedData();
 	}
 
-	std::future<void> EditorMesh::ExportGDM()
+	std::future<bool> EditorMesh::ExportGDM()
 	{
-		return std::async(std::launch::async, [=]()
+		// The solver is built here and held by the task, the member can be
+		// reset on this thread while the export is still running
+		Ref<HeatGeodesicSolver> heatSolver;
+		if (m_GeodesicDistanceCalcMethod == 4)
+			heatSolver = GetHeatSolver();
+
+		// The mapping of an older export would keep the file open
+		if (m_ExportSpecs.binary)
+			m_DistanceMatrix.reset();
+
+		return std::async(std::launch::async, [this, heatSolver]()
 			{
-				ComputeNxNGeodesicDistanceMatrix();
+				if (m_ExportSpecs.binary)
+					return ExportBinaryGeodesicDistanceMatrix(heatSolver);
+
+				if (!ComputeNxNGeodesicDistanceMatrix(heatSolver))
+					return false;
+
 				ExportNxNGeodesicDistanceMatrix();
+				return true;
 			}
 		);
 	}
 
-	void EditorMesh::CalculateSmoothNormals()
+	std::filesystem::path EditorMesh::GetGDMPath() const
 	{
-		if (!m_Normals.empty())
-			m_Normals.clear();
-
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
-		{
-			std::vector<Triangle> triangles = GiveTrianglesWithVertex(i);
-			glm::vec3 normal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-			for (auto& triangle : triangles)
-				normal += triangle.GiveNormal(m_Vertices);
-
-			normal = glm::normalize(normal);
-
-			m_Normals.push_back(normal);
-		}
+		return ResourceManager::GetOutputDirectory() / std::string("M_for_" + m_MainMesh.Name + ".gdm");
 	}
 
-	std::vector<Triangle> EditorMesh::GiveTrianglesWithVertex(uint32_t index)
+	bool EditorMesh::LoadGDM()
 	{
-		std::vector<Triangle> result;
+		m_DistanceMatrix.reset();
 
-		uint32_t counter = 0;
+		std::filesystem::path path = GetGDMPath();
+		if (!std::filesystem::exists(path))
+			return false;
 
-		for (auto& triangle : m_Triangles)
+		Ref<DistanceMatrixReader> matrix = DistanceMatrixReader::Create(path);
+		if (!matrix->IsValid() || matrix->GetVertexCount() != m_Vertices.size())
 		{
-			if (triangle.idx1 == index ||
-				triangle.idx2 == index ||
-				triangle.idx3 == index)
-			{
-				result.push_back(triangle);
-				counter++;
-			}
-				
-			if (counter >= m_AdjacencyMap[index].size())
-				break;			
+			GP_WARN("Distance matrix {0} does not match the mesh, ignoring it", path.string());
+			return false;
 		}
 
-		return result;
+		m_DistanceMatrix = matrix;
+		GP_TRACE("Mapped distance matrix {0}", path.string());
+		return true;
 	}
 
-	std::vector<uint32_t> EditorMesh::SampleNPoints(uint32_t sampleCount)
+	float EditorMesh::GetExportProgress() const
 	{
-		std::vector<uint32_t> result;
-		std::set<uint32_t> sampleSet;
-
-		if (sampleCount > m_Vertices.size())
-			sampleCount = m_Vertices.size() - 1;
+		if (m_Vertices.empty())
+			return 0.0f;
 
-		std::srand(std::time(0));
-		int lb = 0, ub = m_Vertices.size() - 1;
-		sampleSet.insert(rand() % (ub - lb + 1) + lb);
+		return (float)m_Count / (float)m_Vertices.size();
+	}
 
-		//sampleSet.insert(0);
+	void EditorMesh::CalculateSmoothNormals()
+	{
+		m_Normals.assign(m_Vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
 
-		for (uint32_t i = 0; i < sampleCount; i++)
+		// Every face adds its normal to its three vertices,
+		// this visits each face once instead of once per vertex
+		for (auto& triangle : m_Triangles)
 		{
-			uint32_t maxDistIndex;
-			float maxDistance = 0.0f;
+			glm::vec3 normal = triangle.GiveNormal(m_Vertices);
 
+			m_Normals[triangle.idx1] += normal;
+			m_Normals[triangle.idx2] += normal;
+			m_Normals[triangle.idx3] += normal;
+		}
 
-			for (uint32_t j = 0; j < m_Vertices.size(); j++)
-			{
+		for (auto& normal : m_Normals)
+			normal = glm::normalize(normal);
+	}
 
-				uint32_t closestDistIndex;
-				float closest = std::numeric_limits<float>::max();
+	void EditorMesh::CalculateSmoothNormals(const std::vector<uint32_t>& vertices)
+	{
+		const HalfEdgeMesh& topology = *GetHalfEdgeMesh();
 
-				if (sampleSet.find(j) == sampleSet.end())
-				{
-					for (auto sample : sampleSet)
-					{
-						float dist =  glm::length(m_Vertices[sample] - m_Vertices[j]); //  //  GiveGeodesicDistanceBetweenVertices(sample, j); //
+		// Same sum as the full version, gathered from the faces around
+		// each vertex so untouched vertices are skipped
+		for (uint32_t vertex : vertices)
+		{
+			glm::vec3 normal(0.0f);
 
-						if (dist < closest)
-						{
-							closestDistIndex = sample;
-							closest = dist;
-						}
+			for (uint32_t c = topology.GetCornerBegin(vertex); c < topology.GetCornerEnd(vertex); c++)
+				normal += m_Triangles[topology.GetFace(topology.GetCorner(c))].GiveNormal(m_Vertices);
 
-					}
+			m_Normals[vertex] = glm::normalize(normal);
+		}
+	}
 
-					if (closest > maxDistance)
-					{
-						maxDistIndex = j;
-						maxDistance = closest;
-					}
-					
-				}
-			}
+	std::vector<Triangle> EditorMesh::GiveTrianglesWithVertex(uint32_t index)
+	{
+		std::vector<Triangle> result;
 
-			GP_TRACE("Finished: {0}", (float)i / (float)sampleCount);
-			GP_FLUSH_TRACE();
+		const HalfEdgeMesh& topology = *GetHalfEdgeMesh();
 
-			if(maxDistance != 0.0f)
-				sampleSet.insert(maxDistIndex);
+		for (uint32_t c = topology.GetCornerBegin(index); c < topology.GetCornerEnd(index); c++)
+			result.push_back(m_Triangles[topology.GetFace(topology.GetCorner(c))]);
 
-			maxDistance = 0.0f;
+		return result;
+	}
 
+	std::vector<uint32_t> EditorMesh::SampleNPoints(uint32_t sampleCount)
+	{
+		Timer t;
 
-		}
+		FarthestPointSampler sampler(m_Adjacency);
+		std::vector<uint32_t> result = sampler.Sample(sampleCount, m_SampleSeed);
 
-		for (auto sample : sampleSet)
-			result.push_back(sample);
+		GP_TRACE("Sampled {0} points in {1} ms, {2} vertices settled", result.size(), t.ElapsedMilliseconds(), sampler.GetSettledCount());
 
 		return result;
-
 	}
 
 	float EditorMesh::GiveGeodesicDistanceBetweenVertices(uint32_t idx1, uint32_t idx2)
 	{
+		if (m_DistanceMatrix)
+			return m_DistanceMatrix->GetDistance(idx1, idx2);
+
+		if (m_PathQueryMode != PathQueryMode::FULL)
+			return m_PathSolver->ComputePath(idx1, idx2, m_PathQueryMode, m_Path);
+
 		ClearNodeTable();
-		ComputeGeodesicDistancesMinHeap(idx1);
+		ComputeGeodesicDistances(idx1);
 		
 		return m_NodeTable[idx2].shortestPathEstimate;
 	}
 
-	glm::vec3 EditorMesh::GetVertex(uint32_t id)
+	const std::vector<VertexNode>& EditorMesh::RunGeodesicDistances(uint32_t source)
 	{
-		return m_Vertices[id];
+		ClearNodeTable();
+		ComputeGeodesicDistances(source);
+
+		return m_NodeTable;
 	}
 
-	// I don't think that I need tangents, bitangents and texture coordinates
-	// for flat shading, it is mainly for coloring individual triangles
-	void EditorMesh::SetupFlatElements()
+	glm::vec3 EditorMesh::GetVertex(uint32_t id)
 	{
-		if (!m_FlatShadeVertices.empty())
-			m_FlatShadeVertices.clear();
-
-		if (!m_FlatShadeNormals.empty())
-			m_FlatShadeNormals.clear();
-
-		if (!m_FlatShadeIndices.empty())
-			m_FlatShadeIndices.clear();
-
-		for (uint32_t i = 0; i < m_Indices.size(); i++)
-			m_FlatShadeVertices.push_back(m_Vertices[m_Indices[i]]);
-
-		for (uint32_t i = 0; i < m_FlatShadeVertices.size(); i++)
-			m_FlatShadeIndices.push_back(i);
-
-		for (uint32_t i = 0; i < m_FlatShadeVertices.size(); i += 3)
-		{
-			glm::vec3 v1 = m_FlatShadeVertices[i];
-			glm::vec3 v2 = m_FlatShadeVertices[i + 1];
-			glm::vec3 v3 = m_FlatShadeVertices[i + 2];
-
-			glm::vec3 normal = ComputeFaceNormal(v1, v2, v3);
-
-			m_FlatShadeNormals.push_back(normal);
-			m_FlatShadeNormals.push_back(normal);
-			m_FlatShadeNormals.push_back(normal);
-		}
-
+		return m_Vertices[id];
 	}
 
-
 	void EditorMesh::SetupLineVertices()
 	{
 		if ((m_StartIndex > -1 && m_StartIndex < m_Vertices.size()) &&
@@ -603,56 +769,44 @@ namespace GP
 		{
 			std::vector<glm::vec3> vertices;
 
-			ClearNodeTable();
-			ComputeGeodesicDistances(m_StartIndex);
+			if (m_PathQueryMode == PathQueryMode::FULL)
+			{
+				ClearNodeTable();
+				ComputeGeodesicDistances(m_StartIndex);
 
-			VertexNode currentNode = m_NodeTable[m_EndIndex];
+				m_Path.clear();
+				for (int current = m_EndIndex; current != -1; current = m_NodeTable[current].prevIndex)
+					m_Path.push_back(current);
 
-			while (currentNode.prevIndex != -1)
+				std::reverse(m_Path.begin(), m_Path.end());
+			}
+			else
 			{
-				glm::vec3 vertNormal = m_Normals[currentNode.index];
-				glm::vec3 lineVertex = m_Vertices[currentNode.index] + vertNormal * m_RenderSpecs.lineDisplacement;
-				vertices.insert(vertices.begin(), lineVertex);				
-				currentNode = m_NodeTable[currentNode.prevIndex];
+				Timer t;
+				m_PathSolver->ComputePath(m_StartIndex, m_EndIndex, m_PathQueryMode, m_Path);
+				m_CalcTime = t.ElapsedMilliseconds();
 			}
 
-			// last vertex
-			glm::vec3 vertNormal = m_Normals[currentNode.index];
-			glm::vec3 lineVertex = m_Vertices[currentNode.index] + vertNormal * m_RenderSpecs.lineDisplacement;
-			vertices.insert(vertices.begin(), lineVertex);
-			currentNode = m_NodeTable[currentNode.prevIndex];
+			for (uint32_t index : m_Path)
+			{
+				glm::vec3 vertNormal = m_Normals[index];
+				vertices.push_back(m_Vertices[index] + vertNormal * m_RenderSpecs.lineDisplacement);
+			}
 
 			m_Line->SetNewVertices(vertices);
 		}
 	}
 
-	void EditorMesh::SetupAdjacencyMap()
+	void EditorMesh::SetupAdjacency()
 	{
-		for (uint32_t i = 0; i < m_Indices.size(); i += 3)
-		{
-			uint32_t idx1 = m_Indices[i];
-			uint32_t idx2 = m_Indices[i + 1];
-			uint32_t idx3 = m_Indices[i + 2];
-
-			if (std::find(m_AdjacencyMap[idx1].begin(), m_AdjacencyMap[idx1].end(), idx2) == m_AdjacencyMap[idx1].end())
-				m_AdjacencyMap[idx1].push_back(idx2);
-			if (std::find(m_AdjacencyMap[idx1].begin(), m_AdjacencyMap[idx1].end(), idx3) == m_AdjacencyMap[idx1].end())
-				m_AdjacencyMap[idx1].push_back(idx3);
-
-			if (std::find(m_AdjacencyMap[idx2].begin(), m_AdjacencyMap[idx2].end(), idx1) == m_AdjacencyMap[idx2].end())
-				m_AdjacencyMap[idx2].push_back(idx1);
-			if (std::find(m_AdjacencyMap[idx2].begin(), m_AdjacencyMap[idx2].end(), idx3) == m_AdjacencyMap[idx2].end())
-				m_AdjacencyMap[idx2].push_back(idx3);
-
-			if (std::find(m_AdjacencyMap[idx3].begin(), m_AdjacencyMap[idx3].end(), idx1) == m_AdjacencyMap[idx3].end())
-				m_AdjacencyMap[idx3].push_back(idx1);
-			if (std::find(m_AdjacencyMap[idx3].begin(), m_AdjacencyMap[idx3].end(), idx2) == m_AdjacencyMap[idx3].end())
-				m_AdjacencyMap[idx3].push_back(idx2);
-		}
+		m_Adjacency.Build(m_Vertices, m_Indices);
+		m_PathSolver = std::make_shared<DijkstraSolver>(m_Adjacency, m_Vertices);
 	}
 
 	void EditorMesh::SetupNodeTable()
 	{
+		m_NodeTable.resize(m_Vertices.size());
+
 		for (uint32_t i = 0; i < m_Vertices.size(); i++)
 		{
 			m_NodeTable[i].index = i;
@@ -661,39 +815,18 @@ namespace GP
 			m_NodeTable[i].visited = false;
 			m_NodeTable[i].seen = false;
 		}
-	}
 
-	void EditorMesh::SetupNodeTableExport()
-	{
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
-		{
-			m_NodeTableExport[i].index = i;
-			m_NodeTableExport[i].prevIndex = -1;
-			m_NodeTableExport[i].shortestPathEstimate = std::numeric_limits<float>::max();
-			m_NodeTableExport[i].visited = false;
-			m_NodeTableExport[i].seen = false;
-		}
+		m_IndexedHeap.Resize(m_Vertices.size());
 	}
 
 	void EditorMesh::ClearNodeTable()
 	{
 		for (auto& el : m_NodeTable)
 		{
-			el.second.prevIndex = -1;
-			el.second.shortestPathEstimate = std::numeric_limits<float>::max();
-			el.second.visited = false;
-			el.second.seen = false;
-		}
-	}
-
-	void EditorMesh::ClearNodeTableExport()
-	{
-		for (auto& el : m_NodeTableExport)
-		{
-			el.second.prevIndex = -1;
-			el.second.shortestPathEstimate = std::numeric_limits<float>::max();
-			el.second.visited = false;
-			el.second.seen = false;
+			el.prevIndex = -1;
+			el.shortestPathEstimate = std::numeric_limits<float>::max();
+			el.visited = false;
+			el.seen = false;
 		}
 	}
 
@@ -710,6 +843,21 @@ namespace GP
 		{
 			ComputeGeodesicDistancesVector(index);
 		}
+		// Use indexed heap
+		else if (m_GeodesicDistanceCalcMethod == 2)
+		{
+			ComputeGeodesicDistancesIndexedHeap(index);
+		}
+		// Use exact window propagation
+		else if (m_GeodesicDistanceCalcMethod == 3)
+		{
+			ComputeGeodesicDistancesExact(index);
+		}
+		// Use heat method
+		else if (m_GeodesicDistanceCalcMethod == 4)
+		{
+			ComputeGeodesicDistancesHeat(index);
+		}
 
 		m_CalcTime = t.ElapsedMilliseconds();
 	}
@@ -732,19 +880,17 @@ namespace GP
 
 			m_NodeTable[topNode->index].visited = true;
 
-			for (auto el : m_AdjacencyMap[topNode->index])
+			for (uint32_t e = m_Adjacency.Begin(topNode->index); e < m_Adjacency.End(topNode->index); e++)
 			{
+				uint32_t el = m_Adjacency.GetNeighbor(e);
 
 				// If the adjacent node has already been visited
 				// do not process it
 				if (m_NodeTable[el].visited)
 					continue;
 
-				// Calculate distance betwene two vertices
-				glm::vec3 current, neighbor;
-				current = m_Vertices[topNode->index];
-				neighbor = m_Vertices[el];
-				float distance = glm::distance(current, neighbor);
+				// Distance between two vertices is stored with the edge
+				float distance = m_Adjacency.GetEdgeLength(e);
 
 				// Compare distance
 				if (distance + m_NodeTable[topNode->index].shortestPathEstimate < m_NodeTable[el].shortestPathEstimate)
@@ -762,97 +908,162 @@ namespace GP
 		}
 	}
 
-	void EditorMesh::ComputeGeodesicDistancesMinHeapExport(uint32_t index)
+	void EditorMesh::ComputeGeodesicDistancesVector(uint32_t index)
 	{
 		// Initialize starting vertex
-		m_NodeTableExport[index].visited = false;
-		m_NodeTableExport[index].shortestPathEstimate = 0.0f;
-		m_NodeTableExport[index].prevIndex = -1;
-		m_NodeTableExport[index].index = index;
-		m_NodeTableExport[index].seen = true;
+		m_NodeTable[index].visited = false;
+		m_NodeTable[index].shortestPathEstimate = 0.0f;
+		m_NodeTable[index].prevIndex = -1;
+		m_NodeTable[index].index = index;
+
 		// Push starting vertex to the queue
-		m_MinHeapExport.push(&m_NodeTableExport[index]);
+		m_Vector.push_back(&m_NodeTable[index]);
 
-		while (!m_MinHeapExport.empty())
+		while (!m_Vector.empty())
 		{
-			VertexNode* topNode = m_MinHeapExport.top();
-			m_MinHeapExport.pop();
+			VertexNode* topNode = *std::min_element(m_Vector.begin(), m_Vector.end(), vecCompare);
+			m_Vector.erase(std::remove(m_Vector.begin(), m_Vector.end(), topNode), m_Vector.end());
 
-			m_NodeTableExport[topNode->index].visited = true;
+			m_NodeTable[topNode->index].visited = true;
 
-			for (auto el : m_AdjacencyMap[topNode->index])
+			for (uint32_t e = m_Adjacency.Begin(topNode->index); e < m_Adjacency.End(topNode->index); e++)
 			{
+				uint32_t el = m_Adjacency.GetNeighbor(e);
 
 				// If the adjacent node has already been visited
 				// do not process it
-				if (m_NodeTableExport[el].visited)
+				if (m_NodeTable[el].visited)
 					continue;
 
-				// Calculate distance betwene two vertices
-				glm::vec3 current, neighbor;
-				current = m_Vertices[topNode->index];
-				neighbor = m_Vertices[el];
-				float distance = glm::distance(current, neighbor);
+				// Distance between two vertices is stored with the edge
+				float distance = m_Adjacency.GetEdgeLength(e);
 
 				// Compare distance
-				if (distance + m_NodeTableExport[topNode->index].shortestPathEstimate < m_NodeTableExport[el].shortestPathEstimate)
+				if (distance + m_NodeTable[topNode->index].shortestPathEstimate < m_NodeTable[el].shortestPathEstimate)
 				{
-					m_NodeTableExport[el].shortestPathEstimate = distance + m_NodeTableExport[topNode->index].shortestPathEstimate;
-					m_NodeTableExport[el].prevIndex = topNode->index;
+					m_NodeTable[el].shortestPathEstimate = distance + m_NodeTable[topNode->index].shortestPathEstimate;
+					m_NodeTable[el].prevIndex = topNode->index;
 				}
 
-				if (!m_NodeTableExport[el].seen)
+				if (!m_NodeTable[el].seen)
 				{
-					m_MinHeapExport.push(&m_NodeTableExport[el]);
-					m_NodeTableExport[el].seen = true;
+					m_Vector.push_back(&m_NodeTable[el]);
+					m_NodeTable[el].seen = true;
 				}
 			}
 		}
 	}
 
-	void EditorMesh::ComputeGeodesicDistancesVector(uint32_t index)
+	void EditorMesh::ComputeGeodesicDistancesIndexedHeap(uint32_t index)
 	{
+		m_IndexedHeap.Clear();
+
 		// Initialize starting vertex
-		m_NodeTable[index].visited = false;
 		m_NodeTable[index].shortestPathEstimate = 0.0f;
 		m_NodeTable[index].prevIndex = -1;
-		m_NodeTable[index].index = index;
+		m_IndexedHeap.Push(index, 0.0f);
 
-		// Push starting vertex to the queue
-		m_Vector.push_back(&m_NodeTable[index]);
-
-		while (!m_Vector.empty())
+		while (!m_IndexedHeap.Empty())
 		{
-			VertexNode* topNode = *std::min_element(m_Vector.begin(), m_Vector.end(), vecCompare);
-			m_Vector.erase(std::remove(m_Vector.begin(), m_Vector.end(), topNode), m_Vector.end());
-
-			m_NodeTable[topNode->index].visited = true;
+			uint32_t current = m_IndexedHeap.Pop();
+			m_NodeTable[current].visited = true;
 
-			for (auto el : m_AdjacencyMap[topNode->index])
+			for (uint32_t e = m_Adjacency.Begin(current); e < m_Adjacency.End(current); e++)
 			{
+				uint32_t el = m_Adjacency.GetNeighbor(e);
 
-				// If the adjacent node has already been visited
-				// do not process it
+				// Popped vertices already have their final distance
 				if (m_NodeTable[el].visited)
 					continue;
 
-				// Calculate distance betwene two vertices
-				glm::vec3 current, neighbor;
-				current = m_Vertices[topNode->index];
-				neighbor = m_Vertices[el];
-				float distance = glm::distance(current, neighbor);
+				float distance = m_NodeTable[current].shortestPathEstimate + m_Adjacency.GetEdgeLength(e);
 
-				// Compare distance
-				if (distance + m_NodeTable[topNode->index].shortestPathEstimate < m_NodeTable[el].shortestPathEstimate)
+				// The heap key always matches shortestPathEstimate, so
+				// lowering one lowers the other
+				if (distance < m_NodeTable[el].shortestPathEstimate)
 				{
-					m_NodeTable[el].shortestPathEstimate = distance + m_NodeTable[topNode->index].shortestPathEstimate;
-					m_NodeTable[el].prevIndex = topNode->index;
+					m_NodeTable[el].shortestPathEstimate = distance;
+					m_NodeTable[el].prevIndex = current;
+					m_IndexedHeap.PushOrDecrease(el, distance);
 				}
+			}
+		}
+	}
 
-				if (!m_NodeTable[el].seen)
+	void EditorMesh::ComputeGeodesicDistancesExact(uint32_t index)
+	{
+		if (!m_ExactSolver)
+			m_ExactSolver = std::make_shared<ExactGeodesicSolver>(*GetHalfEdgeMesh(), m_Vertices);
+
+		m_ExactSolver->ComputeDistances(index);
+		SetupPreviousFromDistances(m_ExactSolver->GetDistances());
+	}
+
+	void EditorMesh::ComputeGeodesicDistancesHeat(uint32_t index)
+	{
+		GetHeatSolver()->ComputeDistances(index);
+		SetupPreviousFromDistances(m_HeatSolver->GetDistances());
+	}
+
+	const Ref<HeatGeodesicSolver>& EditorMesh::GetHeatSolver()
+	{
+		if (!m_HeatSolver)
+		{
+			m_HeatSolver = HeatGeodesicSolver::Create(*GetHalfEdgeMesh(), m_Vertices);
+			GP_TRACE("Heat method factorized in {0} ms", m_HeatSolver->GetFactorizationTime());
+		}
+
+		return m_HeatSolver;
+	}
+
+	std::filesystem::path EditorMesh::GetSpectralBasisPath() const
+	{
+		return ResourceManager::GetOutputDirectory() / std::string("LB_for_" + m_MainMesh.Name + ".lbb");
+	}
+
+	const Ref<SpectralBasis>& EditorMesh::GetSpectralBasis(uint32_t basisSize)
+	{
+		if (m_SpectralBasis && m_SpectralBasis->GetBasisSize() >= std::min(basisSize, (uint32_t)m_Vertices.size() - 1))
+			return m_SpectralBasis;
+
+		m_SpectralBasis = SpectralBasis::Create();
+
+		std::filesystem::path path = GetSpectralBasisPath();
+		if (m_SpectralBasis->Load(path, *m_HalfEdgeMesh, m_Vertices, basisSize))
+		{
+			GP_TRACE("Loaded Laplace-Beltrami basis from {0}", path.string());
+			return m_SpectralBasis;
+		}
+
+		if (!m_SpectralBasis->Compute(*m_HalfEdgeMesh, m_Vertices, basisSize))
+		{
+			m_SpectralBasis.reset();
+			return m_SpectralBasis;
+		}
+
+		if (!m_SpectralBasis->Save(path))
+			GP_WARN("Could not cache the Laplace-Beltrami basis to {0}", path.string());
+
+		return m_SpectralBasis;
+	}
+
+	void EditorMesh::SetupPreviousFromDistances(const std::vector<float>& distances)
+	{
+		for (uint32_t i = 0; i < m_NodeTable.size(); i++)
+			m_NodeTable[i].shortestPathEstimate = distances[i];
+
+		// These paths cross faces, for drawing every vertex points to its
+		// closest neighbor, distances strictly decrease along the chain
+		for (uint32_t i = 0; i < m_NodeTable.size(); i++)
+		{
+			float closest = distances[i];
+			for (uint32_t e = m_Adjacency.Begin(i); e < m_Adjacency.End(i); e++)
+			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
+				if (distances[neighbor] < closest)
 				{
-					m_Vector.push_back(&m_NodeTable[el]);
-					m_NodeTable[el].seen = true;
+					closest = distances[neighbor];
+					m_NodeTable[i].prevIndex = neighbor;
 				}
 			}
 		}
@@ -864,64 +1075,69 @@ namespace GP
 						  Ref<EnvironmentMap> envMap,
 						  uint32_t ditheringTex) const
 	{
+		// Matches the COLOR_SOURCE defines of ColorShader.glsl
+		const int COLOR_SOURCE_ALBEDO = 0;
+		const int COLOR_SOURCE_VERTEX = 1;
+		const int COLOR_SOURCE_FACE = 2;
+
 		if (m_RenderSpecs.fill)
 		{
 			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+			int colorSource = COLOR_SOURCE_ALBEDO;
+			bool flatShading = false;
+
+			// Switching modes only changes the scalar stream bound to
+			// the shared vertex array
 			switch (m_RenderSpecs.renderMode)
 			{
 				case(RENDERMODE::AGD):
-					colorShader->Bind();
-					colorShader->SetFloat(0, m_RenderSpecs.roughness);
-					colorShader->SetFloat(1, m_RenderSpecs.metalness);
-					envMap->BindIrradianceMap(0);
-					envMap->BindPrefilterMap(1);
-					envMap->BindBrdfLUT(2);
-					glBindTextureUnit(3, ditheringTex);
-					RenderCommand::DrawIndexedBinded(m_AGDVertexArray, m_Indices.size());
-					break;
-				case(RENDERMODE::FLAT):
-					mainShader->Bind();
-					mainShader->SetFloat(0, m_RenderSpecs.roughness);
-					mainShader->SetFloat(1, m_RenderSpecs.metalness);
-					mainShader->SetFloat3(2, m_RenderSpecs.albedo);
-					envMap->BindIrradianceMap(0);
-					envMap->BindPrefilterMap(1);
-					envMap->BindBrdfLUT(2);
-					glBindTextureUnit(3, ditheringTex);
-					RenderCommand::DrawIndexedBinded(m_QualityVertexArray, m_FlatShadeIndices.size());
+					m_VertexArray->SetVertexBuffer(1, m_AGDScalarBuffer);
+					colorSource = COLOR_SOURCE_VERTEX;
 					break;
 				case(RENDERMODE::GC):
-					colorShader->Bind();
-					colorShader->SetFloat(0, m_RenderSpecs.roughness);
-					colorShader->SetFloat(1, m_RenderSpecs.metalness);
-					envMap->BindIrradianceMap(0);
-					envMap->BindPrefilterMap(1);
-					envMap->BindBrdfLUT(2);
-					glBindTextureUnit(3, ditheringTex);
-					RenderCommand::DrawIndexedBinded(m_GCVertexArray, m_Indices.size());
+					m_VertexArray->SetVertexBuffer(1, m_GCScalarBuffer);
+					colorSource = COLOR_SOURCE_VERTEX;
 					break;
 				case(RENDERMODE::QUALITY):
-					colorShader->Bind();
-					colorShader->SetFloat(0, m_RenderSpecs.roughness);
-					colorShader->SetFloat(1, m_RenderSpecs.metalness);
-					envMap->BindIrradianceMap(0);
-					envMap->BindPrefilterMap(1);
-					envMap->BindBrdfLUT(2);
-					glBindTextureUnit(3, ditheringTex);
-					RenderCommand::DrawIndexedBinded(m_QualityVertexArray, m_FlatShadeIndices.size());
+					colorSource = COLOR_SOURCE_FACE;
+					flatShading = true;
+					break;
+				case(RENDERMODE::FLAT):
+					flatShading = true;
+					break;
+				case(RENDERMODE::SCALAR):
+					// Drawn with the albedo until a field is set
+					if (m_ScalarFieldBuffer)
+					{
+						m_VertexArray->SetVertexBuffer(1, m_ScalarFieldBuffer);
+						colorSource = COLOR_SOURCE_VERTEX;
+					}
 					break;
 				case(RENDERMODE::SMOOTH):
-					mainShader->Bind();
-					mainShader->SetFloat(0, m_RenderSpecs.roughness);
-					mainShader->SetFloat(1, m_RenderSpecs.metalness);
-					mainShader->SetFloat3(2, m_RenderSpecs.albedo);
-					envMap->BindIrradianceMap(0);
-					envMap->BindPrefilterMap(1);
-					envMap->BindBrdfLUT(2);
-					glBindTextureUnit(3, ditheringTex);
-					RenderCommand::DrawIndexedBinded(m_VertexArray, m_Indices.size());
 					break;
 			}
+
+			glm::vec2 range = GetScalarRange(m_RenderSpecs.renderMode);
+			if (!m_RenderSpecs.autoScalarRange)
+				range = glm::vec2(m_RenderSpecs.scalarMin, m_RenderSpecs.scalarMax);
+
+			colorShader->Bind();
+			colorShader->SetFloat(0, m_RenderSpecs.roughness);
+			colorShader->SetFloat(1, m_RenderSpecs.metalness);
+			colorShader->SetFloat3(2, m_RenderSpecs.albedo);
+			colorShader->SetInt(3, colorSource);
+			colorShader->SetInt(4, flatShading ? 1 : 0);
+			colorShader->SetFloat(5, range.x);
+			colorShader->SetFloat(6, range.y);
+			colorShader->SetInt(7, (int)m_RenderSpecs.colormap);
+			envMap->BindIrradianceMap(0);
+			envMap->BindPrefilterMap(1);
+			envMap->BindBrdfLUT(2);
+			glBindTextureUnit(3, ditheringTex);
+			m_ColormapTexture->Bind(4);
+			m_QualityScalars->Bind(5);
+			RenderCommand::DrawIndexedBinded(m_VertexArray, m_Indices.size());
 		}
 
 		if (m_RenderSpecs.line)
@@ -954,249 +1170,439 @@ namespace GP
 
 	}
 
-	void EditorMesh::CalculateGaussianCurvatureColors()
+	void EditorMesh::CalculateAverageGeodesicDistances()
 	{
-		if (!m_GaussianCurvatureColors.empty())
-			m_GaussianCurvatureColors.clear();
-
-		std::vector<float> gaussianCurvatureNumbers;
-
-		float maxCurvature = 0.0f;
+		// A running pass has to finish first, it is restarted with the
+		// current vertices and method when it does
+		if (m_AGDTask.valid())
+		{
+			m_AGDTaskStale = true;
+			m_AverageGeodesicDistances.resize(m_Vertices.size(), 0.0f);
+			return;
+		}
 
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
+		if (m_GeodesicDistanceCalcMethod == 3)
 		{
-			std::vector<Triangle> triangles = GiveTrianglesWithVertex(i);
+			StartExactAverageGeodesicDistances();
+			return;
+		}
 
-			float totalCurvature = 0.0f;
+		std::vector<float>& avgDistances = m_AverageGeodesicDistances;
+		avgDistances.assign(m_Vertices.size(), 0.0f);
 
-			for (auto triangle : triangles)
-			{
-				glm::vec3 v1, v2, v3;
 
-				v1 = m_Vertices[i];
+		// The heat method solves all samples as one block
+		if (m_GeodesicDistanceCalcMethod == 4)
+		{
+			std::vector<float> distances(m_SamplePoints.size() * m_Vertices.size());
+			GetHeatSolver()->ComputeDistances(m_SamplePoints, distances.data());
 
-				if (triangle.idx1 == i)
-				{
-					v2 = m_Vertices[triangle.idx2];
-					v3 = m_Vertices[triangle.idx3];
-				}
-				else if (triangle.idx2 == i)
+			for (uint32_t i = 0; i < m_SamplePoints.size(); i++)
+			{
+				for (uint32_t j = 0; j < m_Vertices.size(); j++)
 				{
-					v2 = m_Vertices[triangle.idx1];
-					v3 = m_Vertices[triangle.idx3];
+					avgDistances[j] += distances[i * m_Vertices.size() + j];
 				}
-				else if (triangle.idx3 == i)
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < m_SamplePoints.size(); i++)
+			{
+				ClearNodeTable();
+				ComputeGeodesicDistances(m_SamplePoints[i]);
+
+				for (uint32_t j = 0; j < m_Vertices.size(); j++)
 				{
-					v2 = m_Vertices[triangle.idx1];
-					v3 = m_Vertices[triangle.idx2];
+					avgDistances[j] += m_NodeTable[j].shortestPathEstimate;
 				}
+			}
+		}
 
-				glm::vec3 ed1 = normalize(v2 - v1);
-				glm::vec3 ed2 = normalize(v3 - v1);
+		for (uint32_t i = 0; i < avgDistances.size(); i++)
+			avgDistances[i] /= m_SamplePoints.size();
+	}
 
-				float cos = glm::dot(ed1, ed2);
+	void EditorMesh::StartExactAverageGeodesicDistances()
+	{
+		// Values of the last pass stay on screen, a new topology starts
+		// from zero so the scalar buffer keeps the vertex count
+		m_AverageGeodesicDistances.resize(m_Vertices.size(), 0.0f);
 
-				totalCurvature += 2 * glm::pi<float>() - cos;
-			}
+		Ref<HalfEdgeMesh> topology = GetHalfEdgeMesh();
 
+		m_AGDTask = std::async(std::launch::async, [topology, vertices = m_Vertices, samples = m_SamplePoints]()
+			{
+				Timer t;
 
-			gaussianCurvatureNumbers.push_back(totalCurvature);
+				uint32_t vertexCount = (uint32_t)vertices.size();
+				uint32_t sampleCount = (uint32_t)samples.size();
 
-			if (totalCurvature > maxCurvature)
-				maxCurvature = totalCurvature;
-		}
+				// Sources are independent, every thread runs its own solver
+				// over the shared read-only topology
+				std::vector<float> distances((size_t)sampleCount * vertexCount);
+				ParallelFor(sampleCount, [&](uint32_t begin, uint32_t end)
+					{
+						ExactGeodesicSolver solver(*topology, vertices);
+						for (uint32_t i = begin; i < end; i++)
+							solver.ComputeDistances(samples[i], distances.data() + (size_t)i * vertexCount);
+					}, 1);
 
-		// color interpolation
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
-		{
-			m_GaussianCurvatureColors.push_back(GiveGradientColorBetweenRedAndBlue(gaussianCurvatureNumbers[i] / maxCurvature));
-		}
+				std::vector<float> avgDistances(vertexCount, 0.0f);
+				for (uint32_t i = 0; i < sampleCount; i++)
+				{
+					for (uint32_t j = 0; j < vertexCount; j++)
+						avgDistances[j] += distances[(size_t)i * vertexCount + j];
+				}
 
+				for (uint32_t j = 0; j < vertexCount; j++)
+					avgDistances[j] /= sampleCount;
+
+				GP_TRACE("Exact AGD of {0} samples took {1} ms", sampleCount, t.ElapsedMilliseconds());
+				return avgDistances;
+			}
+		);
 	}
 
-	void EditorMesh::CalculateAGDColors()
+	void EditorMesh::PollAverageGeodesicDistances()
 	{
+		if (!m_AGDTask.valid() || m_AGDTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
 
-		m_AverageGeodesicDistanceColors.clear();
-		m_SamplePoints.clear();
-		m_SamplePoints = SampleNPoints(5);
+		std::vector<float> avgDistances = m_AGDTask.get();
 
+		if (m_AGDTaskStale)
+		{
+			m_AGDTaskStale = false;
+			MarkDirty(MeshData::AGD);
+			return;
+		}
 
-		std::vector<float> avgDistances;
-		avgDistances.resize(m_Vertices.size(), 0.0f);
+		m_AverageGeodesicDistances = std::move(avgDistances);
+		MarkDirty(MeshData::AGD_BUFFER);
+	}
 
+	void EditorMesh::CalculateTriangleQualities(const std::vector<uint32_t>& faces)
+	{
+		m_TriangleQualities.resize(m_Triangles.size(), 0.0f);
 
-		for (uint32_t i = 0; i < m_SamplePoints.size(); i++)
-		{
-			ClearNodeTable();
-			ComputeGeodesicDistances(m_SamplePoints[i]);
+		for (uint32_t i : faces)
+			m_TriangleQualities[i] = m_Triangles[i].CalculateQuality(m_Vertices);
+	}
 
-			float distanceSum = 0.0f;
-			float maxDistance = 0.0f;
+	void EditorMesh::SetupArrayBuffer()
+	{
+		uint32_t size = m_Vertices.size() * sizeof(SurfaceVertex);
 
-			for (uint32_t j = 0; j < m_Vertices.size(); j++)
-			{
-				avgDistances[j] += m_NodeTable[j].shortestPathEstimate;
-			}
+		if (!m_VertexBuffer)
+		{
+			m_VertexBuffer = VertexBuffer::CreateDynamic(size);
+			m_VertexBuffer->SetLayout(
+				{
+					{ ShaderDataType::Float3, "a_Position" },
+					{ ShaderDataType::Float3, "a_Normal" }
+				}
+			);
 		}
-
-		float maxDistance = 0.0f;
-		for (uint32_t i = 0; i < avgDistances.size(); i++)
+		else if (m_VertexBuffer->GetSize() < size)
 		{
-			avgDistances[i] /= m_SamplePoints.size();
+			m_VertexBuffer->SetData(nullptr, size);
+		}
+
+		// Positions and normals are interleaved straight into the mapped
+		// buffer, there is no CPU side copy of the stream unless the
+		// mapping fails
+		SurfaceVertex* surface = (SurfaceVertex*)m_VertexBuffer->Map();
+		bool mapped = surface != nullptr;
 
-			if (avgDistances[i] > maxDistance)
-				maxDistance = avgDistances[i];
+		std::vector<SurfaceVertex> staging;
+		if (!mapped)
+		{
+			GP_WARN("Could not map the vertex buffer of {0}, uploading through a copy", m_MainMesh.Name);
+			staging.resize(m_Vertices.size());
+			surface = staging.data();
 		}
 
-		for (uint32_t i = 0; i < avgDistances.size(); i++)
+		for (uint32_t i = 0; i < m_Vertices.size(); i++)
 		{
-			m_AverageGeodesicDistanceColors.push_back(GiveGradientColorBetweenRedAndBlue(avgDistances[i] / maxDistance));
+			surface[i].Pos = m_Vertices[i];
+			surface[i].Normal = m_Normals[i];
 		}
 
+		if (mapped)
+			m_VertexBuffer->Unmap();
+		else
+			m_VertexBuffer->SetData(staging.data(), size);
 	}
 
-	void EditorMesh::CalculateQualityColors()
+	void EditorMesh::SetupMesh()
 	{
+		// After the first call only the surface stream is rewritten, the
+		// vertex array, the scalar streams and the index buffer stay
+		if (m_VertexArray)
+			return;
 
-		m_QualityColors.clear();
-
+		m_VertexArray = VertexArray::Create();
 
-		std::vector<float> qualityVector;
+		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+		m_VertexArray->AddVertexBuffer(m_AGDScalarBuffer);
+		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+	}
 
-		float maxQuality = 0.0f;
-		
-		for (uint32_t i = 0; i < m_Triangles.size(); i++)
-		{
-			if (i == 5)
-				std::cout << "i = 5" << std::endl;
-			float quality = m_Triangles[i].CalculateQuality(m_Vertices);
-			if (quality > maxQuality)
-				maxQuality = quality;
+	// Minimum and maximum of a scalar field
+	static glm::vec2 FindRange(const std::vector<float>& values)
+	{
+		auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+		return glm::vec2(*minIt, *maxIt);
+	}
 
-			qualityVector.push_back(quality);
-			qualityVector.push_back(quality);
-			qualityVector.push_back(quality);
-		}
+	void EditorMesh::SetupScalarBuffer(Ref<VertexBuffer>& scalarBuffer, glm::vec2& range, const std::vector<float>& values)
+	{
+		range = FindRange(values);
 
-		for (uint32_t i = 0; i < qualityVector.size(); i++)
+		if (scalarBuffer)
 		{
-			m_QualityColors.push_back(GiveGradientColorBetweenRedAndBlue(qualityVector[i] / maxQuality));
+			scalarBuffer->SetData(&values[0], values.size() * sizeof(float));
+			return;
 		}
+
+		scalarBuffer = VertexBuffer::Create(&values[0], values.size() * sizeof(float));
+		scalarBuffer->SetLayout(
+			{
+				{ ShaderDataType::Float, "a_Scalar" }
+			}
+		);
 	}
 
-	void EditorMesh::CalculateColors()
+	void EditorMesh::SetupQualityScalars()
 	{
-		CalculateGaussianCurvatureColors();
-		CalculateAGDColors();
-		CalculateQualityColors();
+		m_QualityRange = FindRange(m_TriangleQualities);
+
+		if (!m_QualityScalars)
+			m_QualityScalars = BufferTexture::Create(m_TriangleQualities.size());
+
+		m_QualityScalars->SetData(&m_TriangleQualities[0], m_TriangleQualities.size() * sizeof(float));
 	}
 
-	void EditorMesh::SetupColoringBuffers()
+	// Polynomial fit of matplotlib's viridis
+	static glm::vec3 GiveViridisColor(float t)
 	{
+		const glm::vec3 c0 = glm::vec3( 0.2777273272234177,  0.005407344544966578,  0.3340998053353061);
+		const glm::vec3 c1 = glm::vec3( 0.1050930431085774,  1.404613529898575,     1.384590162594685);
+		const glm::vec3 c2 = glm::vec3(-0.3308618287255563,  0.214847559468213,     0.09509516302823659);
+		const glm::vec3 c3 = glm::vec3(-4.634230498983486,  -5.799100973351585,   -19.33244095627987);
+		const glm::vec3 c4 = glm::vec3( 6.228269936347081,  14.17993336680509,     56.69055260068105);
+		const glm::vec3 c5 = glm::vec3( 4.776384997670288, -13.74514537774601,    -65.35303263337234);
+		const glm::vec3 c6 = glm::vec3(-5.435455855934631,   4.645852612178535,    26.3124352495832);
+
+		return glm::clamp(c0 + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * (c5 + t * c6))))), 0.0f, 1.0f);
 	}
 
-	void EditorMesh::SetupArrayBufferForColoring(std::vector<ColoringVertex>& coloringArrayBuffer, 
-		                                         const std::vector<glm::vec3>& colors)
+	void EditorMesh::SetupColormap()
 	{
-		coloringArrayBuffer.clear();
+		if (m_ColormapTexture)
+			return;
 
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
+		// One row per COLORMAP, sampled once instead of per vertex
+		const uint32_t COLORMAP_SIZE = 256;
+		const uint32_t COLORMAP_COUNT = 3;
+
+		std::vector<glm::vec3> colormaps(COLORMAP_SIZE * COLORMAP_COUNT);
+		for (uint32_t i = 0; i < COLORMAP_SIZE; i++)
 		{
-			// Coloring vertex this time
-			ColoringVertex vert;
-			vert.Pos = m_Vertices[i];
-			vert.Normal = m_Normals[i];
-			vert.Color = colors[i];
+			float t = (float)i / (float)(COLORMAP_SIZE - 1);
 
-			coloringArrayBuffer.push_back(vert);
+			colormaps[(uint32_t)COLORMAP::REDBLUE * COLORMAP_SIZE + i] = GiveGradientColorBetweenRedAndBlue(t);
+			colormaps[(uint32_t)COLORMAP::VIRIDIS * COLORMAP_SIZE + i] = GiveViridisColor(t);
+			colormaps[(uint32_t)COLORMAP::GRAYSCALE * COLORMAP_SIZE + i] = glm::vec3(t);
 		}
+
+		m_ColormapTexture = Texture2D::CreateF(COLORMAP_SIZE, COLORMAP_COUNT, glm::value_ptr(colormaps[0]), 3);
 	}
 
-	void EditorMesh::SetupArrayBufferForFlatColoring(std::vector<ColoringVertex>& coloringArrayBuffer,
-													 const std::vector<glm::vec3>& colors)
+	void EditorMesh::SetScalarField(const std::vector<float>& values)
 	{
-		coloringArrayBuffer.clear();
+		if (values.size() != m_Vertices.size())
+		{
+			GP_WARN("Scalar field has {0} values but the mesh has {1} vertices", values.size(), m_Vertices.size());
+			return;
+		}
+
+		SetupScalarBuffer(m_ScalarFieldBuffer, m_ScalarFieldRange, values);
+	}
+
+	glm::vec2 EditorMesh::GetScalarRange(RENDERMODE mode) const
+	{
+		switch (mode)
+		{
+			case(RENDERMODE::AGD):
+				return m_AGDRange;
+			case(RENDERMODE::GC):
+				return m_GCRange;
+			case(RENDERMODE::QUALITY):
+				return m_QualityRange;
+			case(RENDERMODE::SCALAR):
+				return m_ScalarFieldRange;
+			default:
+				return glm::vec2(0.0f, 1.0f);
+		}
+	}
 
-		for (uint32_t i = 0; i < m_FlatShadeVertices.size(); i++)
+	void EditorMesh::RunGeodesicRowWorkers(const std::function<void(DijkstraSolver&, uint32_t)>& processRow)
+	{
+		uint32_t vertexCount = m_Vertices.size();
+		m_Count = 0;
+
+		// Rows are handed out one at a time, a worker that finishes early
+		// simply takes the next source
+		std::atomic<uint32_t> nextRow = 0;
+
+		m_FutureVector.clear();
+		for (int i = 0; i < m_CoreSize; i++)
 		{
-			ColoringVertex vert;
-			vert.Pos = m_FlatShadeVertices[i];
-			vert.Normal = m_FlatShadeNormals[i];
-			vert.Color = colors[i];
+			m_FutureVector.push_back(std::async(std::launch::async, [&]()
+				{
+					DijkstraSolver solver(m_Adjacency);
 
-			coloringArrayBuffer.push_back(vert);
+					uint32_t row;
+					while ((row = nextRow++) < vertexCount)
+					{
+						processRow(solver, row);
+						m_Count++;
+					}
+				}
+			));
 		}
-		
+
+		for (auto& future : m_FutureVector)
+			future.wait();
+
+		m_FutureVector.clear();
 	}
 
-	void EditorMesh::SetupMeshForColoring(Ref<VertexArray>& coloringVertexArray,
-										  Ref<VertexBuffer>& coloringVertexBuffer,
-										  std::vector<ColoringVertex>& coloringArrayBuffer,
-										  Ref<IndexBuffer>& coloringIndexBuffer)
+	bool EditorMesh::ComputeNxNGeodesicDistanceMatrix(Ref<HeatGeodesicSolver> heatSolver)
 	{
-		//if (coloringVertexArray.get())
-			// delete coloringVertexArray.get();
+		uint32_t vertexCount = m_Vertices.size();
+
+		// Rows are allocated up front so workers can write
+		// their results without any synchronization
+		m_NxNGeodesicDistanceMatrix.assign(vertexCount, std::vector<float>(vertexCount));
 
-		coloringVertexArray = VertexArray::Create();
+		if (m_GeodesicDistanceCalcMethod == 4)
+		{
+			bool solved = RunHeatGeodesicRows(heatSolver, [&](uint32_t row, const float* distances)
+				{
+					std::copy(distances, distances + vertexCount, m_NxNGeodesicDistanceMatrix[row].begin());
+				}
+			);
+
+			if (!solved)
+				GP_ERROR("Heat method factorization failed, distance matrix of {0} is not exported", m_MainMesh.Name);
+
+			return solved;
+		}
 
-		coloringVertexBuffer = VertexBuffer::Create(&coloringArrayBuffer[0], coloringArrayBuffer.size() * sizeof(ColoringVertex));
-		coloringVertexBuffer->SetLayout(
+		RunGeodesicRowWorkers([&](DijkstraSolver& solver, uint32_t row)
 			{
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float3, "a_Color"}
+				solver.ComputeDistances(row, m_NxNGeodesicDistanceMatrix[row].data());
 			}
 		);
 
-		coloringVertexArray->AddVertexBuffer(coloringVertexBuffer);
-		coloringIndexBuffer = IndexBuffer::Create(&m_Indices[0], m_Indices.size());
-		coloringVertexArray->SetIndexBuffer(coloringIndexBuffer);
+		return true;
 	}
 
-	void EditorMesh::SetupMeshForFlatColoring(Ref<VertexArray>& coloringVertexArray,
-											  Ref<VertexBuffer>& coloringVertexBuffer,
-											  std::vector<ColoringVertex>& coloringArrayBuffer,
-											  Ref<IndexBuffer>& coloringIndexBuffer)
+	bool EditorMesh::RunHeatGeodesicRows(const Ref<HeatGeodesicSolver>& solver, const std::function<void(uint32_t, const float*)>& processRow)
 	{
-		//if (coloringVertexArray.get())
-			//delete coloringVertexArray.get();
+		uint32_t vertexCount = m_Vertices.size();
+		m_Count = 0;
+
+		if (!solver || !solver->IsValid())
+			return false;
 
-		coloringVertexArray = VertexArray::Create();
+		// A block holds enough sources to keep every core busy while the
+		// buffer stays a small part of the full matrix
+		uint32_t blockSize = std::min(vertexCount, 256u * (uint32_t)m_CoreSize);
+		std::vector<uint32_t> sources;
+		std::vector<float> distances((uint64_t)blockSize * vertexCount);
+
+		for (uint32_t first = 0; first < vertexCount; first += blockSize)
+		{
+			uint32_t count = std::min(blockSize, vertexCount - first);
 
-		coloringVertexBuffer = VertexBuffer::Create(&coloringArrayBuffer[0], coloringArrayBuffer.size() * sizeof(ColoringVertex));
-		coloringVertexBuffer->SetLayout(
+			sources.resize(count);
+			std::iota(sources.begin(), sources.end(), first);
+
+			if (!solver->ComputeDistances(sources, distances.data()))
+				return false;
+
+			for (uint32_t i = 0; i < count; i++)
 			{
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float3, "a_Color"}
+				processRow(first + i, distances.data() + (uint64_t)i * vertexCount);
+				m_Count++;
 			}
-		);
+		}
 
-		coloringVertexArray->AddVertexBuffer(coloringVertexBuffer);
-		coloringIndexBuffer = IndexBuffer::Create(&m_FlatShadeIndices[0], m_FlatShadeIndices.size());
-		coloringVertexArray->SetIndexBuffer(coloringIndexBuffer);
+		return true;
 	}
 
+	bool EditorMesh::ExportBinaryGeodesicDistanceMatrix(Ref<HeatGeodesicSolver> heatSolver)
+	{
+		Timer timer;
 
+		std::filesystem::path outputPath = GetGDMPath();
 
-	void EditorMesh::ComputeNxNGeodesicDistanceMatrix()
-	{
-		// Clear our node table first
-		ClearNodeTableExport();
+		DistanceMatrixWriter writer(outputPath, m_Vertices.size(), m_ExportSpecs.precision, m_ExportSpecs.storage);
+		if (!writer.IsOpen())
+			return false;
 
-		for (uint32_t i = 0; i < m_Vertices.size(); i++)
+		bool solved = true;
+		std::atomic<bool> written = true;
+
+		// Each row goes to the file as soon as its worker finishes it,
+		// only one row per thread is alive at any time
+		if (m_GeodesicDistanceCalcMethod == 4)
 		{
-			std::vector<float> row;
-			ComputeGeodesicDistancesMinHeapExport(i);
-			for (uint32_t j = 0; j < m_Vertices.size(); j++)
+			solved = RunHeatGeodesicRows(heatSolver, [&](uint32_t row, const float* distances)
+				{
+					if (!writer.WriteRow(row, distances))
+						written = false;
+				}
+			);
+		}
+		else
+		{
+			RunGeodesicRowWorkers([&](DijkstraSolver& solver, uint32_t row)
+				{
+					solver.ComputeDistances(row);
+					if (!writer.WriteRow(row, solver.GetDistances().data()))
+						written = false;
+				}
+			);
+		}
+
+		if (!writer.Close())
+			written = false;
+
+		// A partial file would be mapped as a valid matrix
+		if (!solved || !written)
+		{
+			std::error_code error;
+			std::filesystem::remove(outputPath, error);
+
+			if (!solved)
 			{
-				row.push_back(m_NodeTableExport[j].shortestPathEstimate);
+				GP_ERROR("Heat method factorization failed, distance matrix of {0} is not exported", m_MainMesh.Name);
+			}
+			else
+			{
+				GP_ERROR("Could not write the distance matrix of {0} to {1}", m_MainMesh.Name, outputPath.string());
 			}
 
-			m_NxNGeodesicDistanceMatrix.push_back(row);
-			ClearNodeTableExport();
+			return false;
 		}
+
+		GP_INFO("Distance matrix of {0} exported to {1} in {2} ms", m_MainMesh.Name, outputPath.string(), timer.ElapsedMilliseconds());
+		return true;
 	}
 
 	void EditorMesh::ExportNxNGeodesicDistanceMatrix()
@@ -12,10 +12,22 @@
 #include <GeoProcess/System/Geometry/Model.h>
 #include <GeoProcess/System/Geometry/Line.h>
 #include <GeoProcess/System/Geometry/Icosphere.h>
+#include <GeoProcess/System/Geometry/VertexAdjacency.h>
 #include <GeoProcess/System/RenderSystem/Shader.h>
 #include <GeoProcess/System/RenderSystem/VertexArray.h>
+#include <GeoProcess/System/RenderSystem/Texture.h>
 #include <GeoProcess/System/RenderSystem/EnvironmentMap.h>
 
+#include <MeshOperations/GeodesicSolver.h>
+#include <MeshOperations/ExactGeodesicSolver.h>
+#include <MeshOperations/HeatGeodesicSolver.h>
+#include <MeshOperations/ImplicitSmoother.h>
+#include <MeshOperations/SpectralBasis.h>
+#include <MeshOperations/IndexedHeap.h>
+#include <MeshOperations/FarthestPointSampler.h>
+#include <MeshOperations/DiscreteCurvature.h>
+#include <MeshOperations/DistanceMatrixFile.h>
+
 namespace GP
 {
 
@@ -25,7 +37,16 @@ namespace GP
 		FLAT = 1,
 		GC = 2,
 		QUALITY = 3,
-		SMOOTH = 4	
+		SMOOTH = 4,
+		SCALAR = 5
+	};
+
+	// Rows of the colormap texture
+	enum class COLORMAP
+	{
+		REDBLUE = 0,
+		VIRIDIS = 1,
+		GRAYSCALE = 2
 	};
 
 	struct RenderSpecs
@@ -46,6 +67,13 @@ namespace GP
 		float metalness = 0.35f;
 		glm::vec3 albedo = glm::vec3(1.0, 1.0, 1.0);
 
+		// Scalar modes map [scalarMin, scalarMax] onto the colormap, the
+		// range of the drawn field is used unless autoScalarRange is off
+		COLORMAP colormap = COLORMAP::REDBLUE;
+		bool autoScalarRange = true;
+		float scalarMin = 0.0f;
+		float scalarMax = 1.0f;
+
 		bool backfaceCulling = true;
 		bool showSamples = false;
 
@@ -143,12 +171,43 @@ namespace GP
 	};
 
 
-	// This struct will be used for coloring
-	struct ColoringVertex
+	// Data EditorMesh derives from its vertices and indices. Marking one
+	// of them dirty also marks everything computed from it, see
+	// EditorMesh::MarkDirty for the dependencies
+	enum class MeshData : uint32_t
+	{
+		// Triangles, half-edge mesh, adjacency and node table
+		TOPOLOGY       = 1 << 0,
+		EDGE_LENGTHS   = 1 << 1,
+		// Mapped distance matrix, exact and heat solvers
+		GEODESICS      = 1 << 2,
+		NORMALS        = 1 << 3,
+		CURVATURE      = 1 << 4,
+		QUALITY        = 1 << 5,
+		// Farthest point samples only depend on the topology, moving
+		// vertices updates the distances to them
+		SAMPLES        = 1 << 6,
+		AGD            = 1 << 7,
+		// Shared position and normal stream
+		SURFACE_BUFFER = 1 << 8,
+		// Scalar streams of the coloring modes
+		AGD_BUFFER     = 1 << 9,
+		GC_BUFFER      = 1 << 10,
+		QUALITY_BUFFER = 1 << 11,
+
+		// Everything that follows from vertex positions
+		POSITIONS = EDGE_LENGTHS | NORMALS | CURVATURE | QUALITY,
+		// Only drawn by some render modes, see EditorMesh::UpdateDerivedData
+		COLORING  = CURVATURE | QUALITY | AGD | AGD_BUFFER | GC_BUFFER | QUALITY_BUFFER,
+		ALL       = (1 << 12) - 1
+	};
+
+	// Shared by every render mode, colors come from separate scalar
+	// streams mapped through a colormap in the shader
+	struct SurfaceVertex
 	{
 		glm::vec3 Pos;
 		glm::vec3 Normal;
-		glm::vec3 Color;
 	};
 
 
@@ -162,8 +221,28 @@ namespace GP
 		static Ref<EditorMesh> Create(Ref<Model> model);
 		static Ref<EditorMesh> Create(std::string name, const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
 
+		// Only the vertices that differ from the current ones count as
+		// moved, normals, curvatures and qualities are recomputed around
+		// them and topology derived data is kept
 		void UpdateVertices(const std::vector<glm::vec3>& newVertices);
 
+		// For callers that rewrite the whole shape, writeVertices fills
+		// the vertex array in place and every vertex counts as moved.
+		// Skips the comparison and the copy of UpdateVertices
+		void UpdateAllVertices(const std::function<void(glm::vec3*)>& writeVertices);
+
+		void MarkDirty(MeshData data);
+		bool IsDirty(MeshData data) const { return (m_DirtyData & (uint32_t)data) != 0; }
+
+		// Rebuilds the dirty data in dependency order, does nothing when
+		// everything is up to date. Coloring data only the other render
+		// modes draw stays dirty until it is drawn or required. Also picks
+		// up a finished background AGD pass, so it is called every frame
+		void UpdateDerivedData();
+		void UpdateDerivedData(MeshData required);
+
+		void SetRenderMode(RENDERMODE mode);
+
 
 		Ref<Mesh> GetMainMesh();
 		Ref<Line> GetLine();
@@ -173,10 +252,23 @@ namespace GP
 
 		// 0 -> min heap
 		// 1 -> vector (array)
-		int m_GeodesicDistanceCalcMethod = 0;
+		// 2 -> indexed 4-ary heap with decrease-key
+		// 3 -> exact polyhedral distances (ICH), not restricted to edges
+		// 4 -> heat method, approximate but every source is two solves
+		int m_GeodesicDistanceCalcMethod = 2;
+
+		// Search used between m_StartIndex and m_EndIndex, FULL runs
+		// m_GeodesicDistanceCalcMethod over the whole mesh
+		PathQueryMode m_PathQueryMode = PathQueryMode::ASTAR;
 		std::string GiveCalcMethodName();
 		std::string GiveRenderMethodName();
 
+		// Runs the selected m_GeodesicDistanceCalcMethod from a single
+		// source, results are left in the returned node table
+		const std::vector<VertexNode>& RunGeodesicDistances(uint32_t source);
+
+		const VertexAdjacency& GetAdjacency() const { return m_Adjacency; }
+
 		// These points are for visualizing geodesic distance
 		// between two vertices
 		int m_StartIndex = -1;
@@ -194,11 +286,15 @@ namespace GP
 		void SetupLineVertices();
 
 		void ExportNxNGeodesicDistanceMatrix();
-		void ComputeNxNGeodesicDistanceMatrix();
+		bool ComputeNxNGeodesicDistanceMatrix(Ref<HeatGeodesicSolver> heatSolver);
+		bool ExportBinaryGeodesicDistanceMatrix(Ref<HeatGeodesicSolver> heatSolver);
 		void ComputeGeodesicDistances(uint32_t index);
 		void ComputeGeodesicDistancesMinHeap(uint32_t index);
-		void ComputeGeodesicDistancesMinHeapExport(uint32_t index);
 		void ComputeGeodesicDistancesVector(uint32_t index);
+		void ComputeGeodesicDistancesIndexedHeap(uint32_t index);
+		void ComputeGeodesicDistancesExact(uint32_t index);
+		void ComputeGeodesicDistancesHeat(uint32_t index);
+		void SetupPreviousFromDistances(const std::vector<float>& distances);
 
 
 	public:
@@ -212,90 +308,137 @@ namespace GP
 			      Ref<Shader> singleColorShader,
 			      Ref<EnvironmentMap> envMap,
 				  uint32_t ditheringTex) const;
+
+		// One press runs m_SmoothingSpecs.iterations steps of the selected
+		// mode, EXPLICIT keeps the old single umbrella step
 		void SmoothingFunction();
+		SmoothingSpecs m_SmoothingSpecs;
 
-		std::future<void> ExportGDM();
-	public:
-		RenderSpecs m_RenderSpecs;
-	public:
+		// The result is true when the matrix was written. The task never
+		// touches m_DistanceMatrix, call LoadGDM on this thread once it
+		// finished to map the new file
+		std::future<bool> ExportGDM();
 
-		std::vector<glm::vec3> m_GaussianCurvatureColors;
-		std::vector<glm::vec3> m_AverageGeodesicDistanceColors;
+		// Maps a previously exported binary matrix of this mesh, distance
+		// queries are answered from it instead of running Dijkstra
+		bool LoadGDM();
+		std::filesystem::path GetGDMPath() const;
 
-		// This is going to be flat
-		std::vector<glm::vec3> m_QualityColors;
+		DistanceMatrixSpecs m_ExportSpecs;
 
+		// Fraction of distance matrix rows finished by the export workers
+		float GetExportProgress() const;
+
+		// Any per vertex field (distances from a source, curvatures,
+		// PCA variance) drawn with RENDERMODE::SCALAR, values are raw
+		void SetScalarField(const std::vector<float>& values);
+
+		// Gaussian, mean and principal curvatures with the Voronoi areas,
+		// any of them can be drawn with SetScalarField
+		const DiscreteCurvature& GetCurvature();
+
+		// Minimum and maximum of the field drawn in the given mode
+		glm::vec2 GetScalarRange(RENDERMODE mode) const;
+
+		// First basisSize Laplace-Beltrami eigenfunctions, read from the
+		// cache in the output directory when it was written for this shape
+		// and computed (then cached) otherwise. Null if the solver fails
+		const Ref<SpectralBasis>& GetSpectralBasis(uint32_t basisSize = 100);
+		std::filesystem::path GetSpectralBasisPath() const;
+	public:
+		RenderSpecs m_RenderSpecs;
+	public:
 		std::vector<uint32_t> m_SamplePoints;
 
+		// Seed of the first farthest point sample, samples are the same
+		// on every run for the same seed
+		uint32_t m_SampleSeed = 0;
+
 		glm::vec3 GetVertex(uint32_t id);
 	private:
-		void CalculateAGDColors();
-		void CalculateGaussianCurvatureColors();
-		void CalculateQualityColors();
+		void CalculateAverageGeodesicDistances();
+
+		// Exact distances take seconds per source on 100k-face meshes, so
+		// method 3 solves the samples on a worker. The previous values are
+		// drawn until it finishes
+		void StartExactAverageGeodesicDistances();
+		void PollAverageGeodesicDistances();
+		void CalculateTriangleQualities(const std::vector<uint32_t>& faces);
+
+		void UpdateDerivedData(uint32_t required);
+
+		// MeshData the current render mode draws on top of the surface
+		uint32_t GetDisplayedData() const;
 
-		void CalculateColors();
+		// Records moved vertices for the next UpdateDerivedData, if most
+		// of the mesh moved everything is recomputed instead
+		void MarkVerticesMoved(const std::vector<uint32_t>& vertices);
 
-		void SetupColoringBuffers();
+		// Vertices whose one-ring contains a moved vertex and faces with
+		// a moved corner, normals and curvatures of the first and the
+		// qualities of the second have to be recomputed
+		void CollectAffectedElements(std::vector<uint32_t>& vertices, std::vector<uint32_t>& faces) const;
 	private:
 		bool isSmooth = false;
 
+		uint32_t m_DirtyData = 0;
+		bool m_AllVerticesMoved = true;
+		std::vector<uint32_t> m_MovedVertices;
+		std::vector<char> m_MovedFlags;
+
+		// Values behind the AGD, GC and quality colors, kept so a partial
+		// update only recomputes the values around moved vertices
+		std::vector<float> m_AverageGeodesicDistances;
+
+		// Background exact AGD pass, it works on copies of the vertices and
+		// samples. m_AGDTaskStale is set when the AGD is requested again
+		// while it runs, its result is then dropped and the pass restarted
+		std::future<std::vector<float>> m_AGDTask;
+		bool m_AGDTaskStale = false;
+		DiscreteCurvature m_Curvature;
+		std::vector<float> m_TriangleQualities;
+
 	private:
 		std::vector<Triangle> m_Triangles;
 
 	private:
 
 
-		// VBO's and VBA's for each coloring mode have separated
-		// They will only be computed only in the beginning and 
-		// when we use the smooth function
-		std::vector<ColoringVertex> m_AGDArrayBuffer;
-		Ref<VertexArray> m_AGDVertexArray;
-		Ref<VertexBuffer> m_AGDVertexBuffer;
-		Ref<IndexBuffer> m_AGDIndexBuffer;
-
-		std::vector<ColoringVertex> m_GCArrayBuffer;
-		Ref<VertexArray> m_GCVertexArray;
-		Ref<VertexBuffer> m_GCVertexBuffer;
-		Ref<IndexBuffer> m_GCIndexBuffer;
-
-		std::vector<ColoringVertex> m_QualityArrayBuffer;
-		Ref<VertexArray> m_QualityVertexArray;
-		Ref<VertexBuffer> m_QualityVertexBuffer;
-		Ref<IndexBuffer> m_QualityIndexBuffer;
+		// One vertex array draws every mode. Binding 0 is the shared
+		// position and normal stream (m_VertexBuffer), binding 1 holds
+		// the scalar stream of the current coloring mode. Per face
+		// qualities are read in the shader through gl_PrimitiveID, so no
+		// vertex is duplicated
+		Ref<VertexBuffer> m_AGDScalarBuffer;
+		Ref<VertexBuffer> m_GCScalarBuffer;
+		Ref<VertexBuffer> m_ScalarFieldBuffer;
+		Ref<BufferTexture> m_QualityScalars;
 
-	private:
-		std::vector<glm::vec3> m_FlatShadeVertices;
-		std::vector<glm::vec3> m_FlatShadeNormals;
-		std::vector<glm::vec3> m_FlatShadeTangents;
-		std::vector<glm::vec3> m_FlatShadeBitangents;
-		std::vector<glm::vec2> m_FlatShadeTexCoords;
+		glm::vec2 m_AGDRange = glm::vec2(0.0f, 1.0f);
+		glm::vec2 m_GCRange = glm::vec2(0.0f, 1.0f);
+		glm::vec2 m_ScalarFieldRange = glm::vec2(0.0f, 1.0f);
+		glm::vec2 m_QualityRange = glm::vec2(0.0f, 1.0f);
 
-		std::vector<uint32_t> m_FlatShadeIndices;
+		Ref<Texture2D> m_ColormapTexture;
 
 	private:
 		float m_SmootingFactor = 0.1f;
 	private:
-		void SetupArrayBufferForColoring(std::vector<ColoringVertex>& coloringArrayBuffer,
-			                             const std::vector<glm::vec3>& colors);
-		void SetupArrayBufferForFlatColoring(std::vector<ColoringVertex>& coloringArrayBuffer,
-										  const std::vector<glm::vec3>& colors);
-
-
-		void SetupMeshForColoring(Ref<VertexArray>& coloringVertexArray,
-			                      Ref<VertexBuffer>& coloringVertexBuffer,
-			                      std::vector<ColoringVertex>& coloringArrayBuffer,
-			                      Ref<IndexBuffer>& coloringIndexBuffer);
+		// The base class versions build the full Vertex layout with
+		// tangents and bone data that the editor never draws
+		virtual void SetupArrayBuffer() override;
+		virtual void SetupMesh() override;
 
-		void SetupMeshForFlatColoring(Ref<VertexArray>& coloringVertexArray,
-									  Ref<VertexBuffer>& coloringVertexBuffer,
-									  std::vector<ColoringVertex>& coloringArrayBuffer,
-									  Ref<IndexBuffer>& coloringIndexBuffer);
+		// Uploads raw values and stores their range, the shader does
+		// the mapping to colors
+		void SetupScalarBuffer(Ref<VertexBuffer>& scalarBuffer, glm::vec2& range, const std::vector<float>& values);
+		void SetupQualityScalars();
+		void SetupColormap();
 
-
-		void SetupFlatElements();
 		void SetupTriangles();
 
 		void CalculateSmoothNormals();
+		void CalculateSmoothNormals(const std::vector<uint32_t>& vertices);
 
 		std::vector<Triangle> GiveTrianglesWithVertex(uint32_t index);
 
@@ -308,25 +451,55 @@ namespace GP
 		Ref<Line> m_Line;
 	private:
 		std::priority_queue<VertexNode*, std::vector<VertexNode*>, Compare> m_MinHeap;
-		std::priority_queue<VertexNode*, std::vector<VertexNode*>, Compare> m_MinHeapExport;
 
 		std::vector<std::vector<float>> m_NxNGeodesicDistanceMatrix;
-		std::unordered_map<uint32_t, std::vector<uint32_t>> m_AdjacencyMap;
-		std::unordered_map<uint32_t, VertexNode> m_NodeTable;
-		std::unordered_map<uint32_t, VertexNode> m_NodeTableExport;
+		Ref<DistanceMatrixReader> m_DistanceMatrix;
+		VertexAdjacency m_Adjacency;
+		std::vector<VertexNode> m_NodeTable;
 		std::vector<VertexNode*> m_Vector;
+		IndexedMinHeap m_IndexedHeap;
+
+		// Point to point queries keep their own solver so repeated
+		// picks only reset the vertices the previous search reached
+		Ref<DijkstraSolver> m_PathSolver;
+		std::vector<uint32_t> m_Path;
+
+		// Created on first use, the window propagation needs the
+		// half-edge topology and its own edge lengths
+		Ref<ExactGeodesicSolver> m_ExactSolver;
+
+		// Holds the factorizations of the heat method, built on first use
+		// and kept until the vertices change
+		Ref<HeatGeodesicSolver> m_HeatSolver;
+		const Ref<HeatGeodesicSolver>& GetHeatSolver();
+
+		// Kept until the vertices change
+		Ref<SpectralBasis> m_SpectralBasis;
+
+		// Keeps its factorization across smoothing presses, a new topology
+		// drops it and any other position change resets its operator
+		Ref<ImplicitSmoother> m_Smoother;
+		bool m_SmootherMovedVertices = false;
 
 
 	private:
 		virtual void BuildVertices() override;
 		void BuildVerticesNoMesh();
-		void SetupAdjacencyMap();
+		void SetupAdjacency();
 		void SetupNodeTable();
-		void SetupNodeTableExport();
 		void ClearNodeTable();
-		void ClearNodeTableExport();
 
 	private:
+		// Worker threads used for the distance matrix, each one owns a
+		// DijkstraSolver and m_Count is the number of finished rows
+		void RunGeodesicRowWorkers(const std::function<void(DijkstraSolver&, uint32_t)>& processRow);
+
+		// Same for m_GeodesicDistanceCalcMethod 4, rows are produced in
+		// blocks of sources by the heat solver. The solver is passed in
+		// so the export thread never touches m_HeatSolver, returns false
+		// when its factorization failed
+		bool RunHeatGeodesicRows(const Ref<HeatGeodesicSolver>& solver, const std::function<void(uint32_t, const float*)>& processRow);
+
 		int m_CoreSize;
 		std::atomic<int> m_Count;
 		std::vector<std::future<void>> m_FutureVector;
@@ -0,0 +1,487 @@
+#include <Precomp.h>
+#include <MeshOperations/ExactGeodesicSolver.h>
+
+#include <glm/gtc/constants.hpp>
+
+namespace GP
+{
+	namespace
+	{
+		const double INF = std::numeric_limits<double>::max();
+
+		// Relative tolerance so round-off never prunes a window that
+		// ties with a vertex
+		bool IsShorter(double a, double b)
+		{
+			return a < b - 1e-9 * b;
+		}
+
+		double Cross(const glm::dvec2& a, const glm::dvec2& b)
+		{
+			return a.x * b.y - a.y * b.x;
+		}
+
+		// Point where the ray from source through the given point leaves
+		// the face through segment pq
+		glm::dvec2 IntersectRay(const glm::dvec2& source, const glm::dvec2& through, const glm::dvec2& p, const glm::dvec2& q)
+		{
+			glm::dvec2 direction = through - source;
+			glm::dvec2 edge = q - p;
+
+			double denominator = Cross(edge, direction);
+			if (std::abs(denominator) < 1e-300)
+				return through;
+
+			double u = Cross(source - p, direction) / denominator;
+			u = std::min(1.0, std::max(0.0, u));
+
+			return p + edge * u;
+		}
+	}
+
+	ExactGeodesicSolver::ExactGeodesicSolver(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices) : m_Mesh(mesh)
+	{
+		UpdateGeometry(vertices);
+	}
+
+	void ExactGeodesicSolver::UpdateGeometry(const std::vector<glm::vec3>& vertices)
+	{
+		uint32_t vertexCount = m_Mesh.GetVertexCount();
+		uint32_t halfEdgeCount = m_Mesh.GetHalfEdgeCount();
+
+		m_EdgeLengths.resize(halfEdgeCount);
+		for (uint32_t h = 0; h < halfEdgeCount; h++)
+			m_EdgeLengths[h] = glm::distance(glm::dvec3(vertices[m_Mesh.GetOrigin(h)]), glm::dvec3(vertices[m_Mesh.GetTarget(h)]));
+
+		// Total angle around every vertex, geodesics can only bend at
+		// saddles (more than 2 pi) or on the boundary. Flat vertices are
+		// crossed straight by the windows on both sides, so round-off
+		// around 2 pi must not turn them into sources
+		std::vector<double> angles(vertexCount, 0.0);
+
+		// No window can cross a face without area, its vertices propagate
+		// like sources so the front continues behind it
+		std::vector<char> degenerate(vertexCount, 0);
+
+		for (uint32_t h = 0; h < halfEdgeCount; h++)
+		{
+			double a = m_EdgeLengths[h];
+			double b = m_EdgeLengths[m_Mesh.GetPrev(h)];
+			double c = m_EdgeLengths[m_Mesh.GetNext(h)];
+
+			glm::dvec3 origin(vertices[m_Mesh.GetOrigin(h)]);
+			glm::dvec3 target(vertices[m_Mesh.GetTarget(h)]);
+			glm::dvec3 opposite(vertices[m_Mesh.GetTarget(m_Mesh.GetNext(h))]);
+
+			double longest = std::max(a, std::max(b, c));
+			if (glm::length(glm::cross(target - origin, opposite - origin)) <= 1e-12 * longest * longest)
+				degenerate[m_Mesh.GetOrigin(h)] = 1;
+
+			if (a <= 0.0 || b <= 0.0)
+				continue;
+
+			double cosine = (a * a + b * b - c * c) / (2.0 * a * b);
+			angles[m_Mesh.GetOrigin(h)] += std::acos(std::min(1.0, std::max(-1.0, cosine)));
+		}
+
+		m_PseudoSource.resize(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			m_PseudoSource[v] = m_Mesh.IsBoundaryVertex(v) || degenerate[v] || angles[v] > glm::two_pi<double>() + 1e-6;
+
+		m_Distances.resize(vertexCount);
+		m_EntryHalfEdge.resize(vertexCount);
+		m_EntryCrossing.resize(vertexCount);
+		m_Result.resize(vertexCount);
+	}
+
+	void ExactGeodesicSolver::ComputeDistances(uint32_t source, float* outDistances)
+	{
+		std::fill(m_Distances.begin(), m_Distances.end(), INF);
+		std::fill(m_EntryHalfEdge.begin(), m_EntryHalfEdge.end(), HalfEdgeMesh::INVALID);
+
+		m_Queue.clear();
+		m_Windows.clear();
+		m_FreeWindows.clear();
+		m_WindowCount = 0;
+		m_PrunedCount = 0;
+
+		// The source is always propagated as a vertex, whatever its angle
+		m_Distances[source] = 0.0;
+		PushEvent({ 0.0, source, HalfEdgeMesh::INVALID });
+
+		while (!m_Queue.empty())
+		{
+			Event event = PopEvent();
+
+			if (event.vertex != HalfEdgeMesh::INVALID)
+			{
+				// A later improvement pushed another event for this vertex
+				if (event.key > m_Distances[event.vertex])
+					continue;
+
+				PropagateVertex(event.vertex);
+			}
+			else
+			{
+				m_FreeWindows.push_back(event.window);
+				PropagateWindow(m_Windows[event.window]);
+			}
+		}
+
+		float* distances = outDistances ? outDistances : m_Result.data();
+		for (uint32_t v = 0; v < m_Distances.size(); v++)
+			distances[v] = m_Distances[v] == INF ? std::numeric_limits<float>::max() : (float)m_Distances[v];
+	}
+
+	void ExactGeodesicSolver::PushEvent(const Event& event)
+	{
+		// Moves a hole up instead of swapping, the event is written once
+		uint32_t position = (uint32_t)m_Queue.size();
+		m_Queue.emplace_back();
+
+		while (position > 0)
+		{
+			uint32_t parent = (position - 1) / 4;
+			if (m_Queue[parent].key <= event.key)
+				break;
+
+			m_Queue[position] = m_Queue[parent];
+			position = parent;
+		}
+
+		m_Queue[position] = event;
+	}
+
+	ExactGeodesicSolver::Event ExactGeodesicSolver::PopEvent()
+	{
+		Event top = m_Queue[0];
+
+		Event entry = m_Queue.back();
+		m_Queue.pop_back();
+
+		uint32_t size = (uint32_t)m_Queue.size();
+		if (size == 0)
+			return top;
+
+		uint32_t position = 0;
+		while (true)
+		{
+			uint32_t first = position * 4 + 1;
+			if (first >= size)
+				break;
+
+			uint32_t last = std::min(first + 4, size);
+			uint32_t smallest = first;
+			for (uint32_t child = first + 1; child < last; child++)
+			{
+				if (m_Queue[child].key < m_Queue[smallest].key)
+					smallest = child;
+			}
+
+			if (entry.key <= m_Queue[smallest].key)
+				break;
+
+			m_Queue[position] = m_Queue[smallest];
+			position = smallest;
+		}
+
+		m_Queue[position] = entry;
+
+		return top;
+	}
+
+	glm::dvec2 ExactGeodesicSolver::GetOppositeCorner(uint32_t halfEdge) const
+	{
+		double length = m_EdgeLengths[halfEdge];
+		double toOrigin = m_EdgeLengths[m_Mesh.GetPrev(halfEdge)];
+		double toTarget = m_EdgeLengths[m_Mesh.GetNext(halfEdge)];
+
+		double x = (length * length + toOrigin * toOrigin - toTarget * toTarget) / (2.0 * length);
+		double y = std::sqrt(std::max(0.0, toOrigin * toOrigin - x * x));
+
+		return glm::dvec2(x, y);
+	}
+
+	void ExactGeodesicSolver::UpdateVertex(uint32_t vertex, double distance, uint32_t halfEdge, double crossing)
+	{
+		if (distance >= m_Distances[vertex])
+			return;
+
+		m_Distances[vertex] = distance;
+		m_EntryHalfEdge[vertex] = halfEdge;
+		m_EntryCrossing[vertex] = crossing;
+
+		if (m_PseudoSource[vertex])
+			PushEvent({ distance, vertex, HalfEdgeMesh::INVALID });
+	}
+
+	void ExactGeodesicSolver::PropagateVertex(uint32_t vertex)
+	{
+		double distance = m_Distances[vertex];
+
+		for (uint32_t i = m_Mesh.GetCornerBegin(vertex); i < m_Mesh.GetCornerEnd(vertex); i++)
+		{
+			uint32_t halfEdge = m_Mesh.GetCorner(i);
+			uint32_t opposite = m_Mesh.GetNext(halfEdge);
+
+			double toTarget = m_EdgeLengths[halfEdge];
+			double toPrevious = m_EdgeLengths[m_Mesh.GetPrev(halfEdge)];
+
+			// Straight paths along the two edges of the face
+			UpdateVertex(m_Mesh.GetTarget(halfEdge), distance + toTarget, HalfEdgeMesh::INVALID, 0.0);
+			UpdateVertex(m_Mesh.GetOrigin(m_Mesh.GetPrev(halfEdge)), distance + toPrevious, HalfEdgeMesh::INVALID, 0.0);
+
+			// The face itself is covered, the window starts on the edge
+			// across from the vertex and enters the neighboring face
+			uint32_t next = m_Mesh.GetOpposite(opposite);
+			if (next == HalfEdgeMesh::INVALID)
+				continue;
+
+			// Frame of the neighbor half-edge starts at the previous
+			// vertex of this face and ends at the target. A collapsed edge
+			// has no frame, its endpoints were reached along the edges above
+			double length = m_EdgeLengths[next];
+			if (length <= 0.0)
+				continue;
+
+			double x = (toPrevious * toPrevious - toTarget * toTarget + length * length) / (2.0 * length);
+			double y = -std::sqrt(std::max(0.0, toPrevious * toPrevious - x * x));
+
+			CreateWindow(next, 0.0, length, glm::dvec2(x, y), distance);
+		}
+	}
+
+	void ExactGeodesicSolver::CreateWindow(uint32_t halfEdge, double b0, double b1, const glm::dvec2& source, double sigma)
+	{
+		double length = m_EdgeLengths[halfEdge];
+
+		b0 = std::max(0.0, b0);
+		b1 = std::min(length, b1);
+
+		auto distanceAt = [&](double x) { return sigma + glm::length(glm::dvec2(x, 0.0) - source); };
+
+		uint32_t origin = m_Mesh.GetOrigin(halfEdge);
+		uint32_t target = m_Mesh.GetTarget(halfEdge);
+
+		double tolerance = 1e-9 * length;
+		if (b0 <= tolerance)
+			UpdateVertex(origin, distanceAt(0.0), HalfEdgeMesh::INVALID, 0.0);
+		if (b1 >= length - tolerance)
+			UpdateVertex(target, distanceAt(length), HalfEdgeMesh::INVALID, 0.0);
+
+		// Degenerate windows carry a single ray which the neighboring
+		// windows already cover
+		if (b1 - b0 <= tolerance)
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		if (!TrimWindow(halfEdge, b0, b1, source, sigma))
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		double closest = std::min(b1, std::max(b0, source.x));
+
+		uint32_t slot;
+		if (m_FreeWindows.empty())
+		{
+			slot = (uint32_t)m_Windows.size();
+			m_Windows.emplace_back();
+		}
+		else
+		{
+			slot = m_FreeWindows.back();
+			m_FreeWindows.pop_back();
+		}
+
+		m_Windows[slot] = { halfEdge, b0, b1, source, sigma };
+		PushEvent({ distanceAt(closest), HalfEdgeMesh::INVALID, slot });
+		m_WindowCount++;
+	}
+
+	bool ExactGeodesicSolver::TrimWindow(uint32_t halfEdge, double& b0, double& b1, const glm::dvec2& source, double sigma) const
+	{
+		double length = m_EdgeLengths[halfEdge];
+		double tolerance = 1e-9 * length;
+
+		auto distanceAt = [&](double x) { return sigma + glm::length(glm::dvec2(x, 0.0) - source); };
+
+		// Distance through the window grows by at most 1 per unit along
+		// the edge, so if an endpoint vertex beats it at the far end of
+		// the window it beats it everywhere
+		uint32_t origin = m_Mesh.GetOrigin(halfEdge);
+		uint32_t target = m_Mesh.GetTarget(halfEdge);
+
+		double fromOrigin = m_Distances[origin];
+		double fromTarget = m_Distances[target];
+
+		if (IsShorter(fromOrigin + b1, distanceAt(b1)) || IsShorter(fromTarget + (length - b0), distanceAt(b0)))
+			return false;
+
+		// Otherwise the origin wins on a prefix of the window and the
+		// target on a suffix, ending where the window distance equals the
+		// path through the vertex. Only sources are cut against, their own
+		// windows cover the rays that are removed
+		double squaredSource = glm::dot(source, source);
+
+		if (m_PseudoSource[origin] && IsShorter(fromOrigin + b0, distanceAt(b0)))
+		{
+			// sigma + |(x, 0) - source| = fromOrigin + x
+			double k = fromOrigin - sigma;
+			if (source.x + k > 0.0)
+				b0 = std::max(b0, (squaredSource - k * k) / (2.0 * (source.x + k)) - tolerance);
+		}
+
+		if (m_PseudoSource[target] && IsShorter(fromTarget + (length - b1), distanceAt(b1)))
+		{
+			// sigma + |(x, 0) - source| = fromTarget + length - x
+			double m = fromTarget + length - sigma;
+			if (m - source.x > 0.0)
+				b1 = std::min(b1, (m * m - squaredSource) / (2.0 * (m - source.x)) + tolerance);
+		}
+
+		return b1 - b0 > tolerance;
+	}
+
+	void ExactGeodesicSolver::CreateChild(const Window& parent, uint32_t edge, const glm::dvec2& edgeOrigin,
+		                                  const glm::dvec2& edgeTarget, const glm::dvec2& from, const glm::dvec2& to)
+	{
+		uint32_t halfEdge = m_Mesh.GetOpposite(edge);
+		if (halfEdge == HalfEdgeMesh::INVALID)
+			return;
+
+		// Rigid motion from the parent frame to the frame of the neighbor
+		// half-edge, the parent face ends up on the -y side
+		glm::dvec2 axis = edgeTarget - edgeOrigin;
+		double edgeLength = glm::length(axis);
+		if (edgeLength <= 0.0)
+			return;
+
+		axis = axis / edgeLength;
+
+		auto toFrame = [&](const glm::dvec2& p)
+		{
+			glm::dvec2 d = p - edgeOrigin;
+			return glm::dvec2(glm::dot(d, axis), Cross(axis, d));
+		};
+
+		glm::dvec2 source = toFrame(parent.source);
+		source.y = std::min(0.0, source.y);
+
+		double b0 = glm::dot(from - edgeOrigin, axis);
+		double b1 = glm::dot(to - edgeOrigin, axis);
+		if (b0 > b1)
+			std::swap(b0, b1);
+
+		CreateWindow(halfEdge, b0, b1, source, parent.sigma);
+	}
+
+	void ExactGeodesicSolver::PropagateWindow(Window window)
+	{
+		uint32_t halfEdge = window.halfEdge;
+		double length = m_EdgeLengths[halfEdge];
+
+		// Windows on collapsed edges are dropped when they are created,
+		// this only keeps the frame below from dividing by zero
+		if (length <= 0.0)
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		uint32_t c = m_Mesh.GetTarget(m_Mesh.GetNext(halfEdge));
+
+		glm::dvec2 A(0.0, 0.0);
+		glm::dvec2 B(length, 0.0);
+		glm::dvec2 C = GetOppositeCorner(halfEdge);
+
+		auto distanceAt = [&](const glm::dvec2& p) { return window.sigma + glm::length(p - window.source); };
+
+		// Vertex distances may have improved since the window was queued,
+		// so the window is trimmed again before it is propagated
+		if (!TrimWindow(halfEdge, window.b0, window.b1, window.source, window.sigma))
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		glm::dvec2 P0(window.b0, 0.0);
+		glm::dvec2 P1(window.b1, 0.0);
+
+		double closest = std::min(window.b1, std::max(window.b0, window.source.x));
+		double nearest = distanceAt(glm::dvec2(closest, 0.0));
+		double farthest = std::max(glm::length(C - P0), glm::length(C - P1));
+
+		// For the opposite vertex the window distance is bounded from
+		// below by its closest point and the vertex distance from above
+		// by the farther endpoint
+		if (IsShorter(m_Distances[c] + farthest, nearest))
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		// Where the ray from the source to the opposite vertex crosses
+		// the edge, the source is never above the edge so this is stable.
+		// A flat face with the source on the edge line has no rays that
+		// enter it
+		double height = C.y - window.source.y;
+		if (height <= 0.0)
+		{
+			m_PrunedCount++;
+			return;
+		}
+
+		double crossing = window.source.x + (C.x - window.source.x) * (-window.source.y) / height;
+
+		uint32_t leftEdge = m_Mesh.GetPrev(halfEdge);
+		uint32_t rightEdge = m_Mesh.GetNext(halfEdge);
+
+		if (crossing <= window.b0)
+		{
+			CreateChild(window, rightEdge, C, B, IntersectRay(window.source, P0, C, B), IntersectRay(window.source, P1, C, B));
+			return;
+		}
+
+		if (crossing >= window.b1)
+		{
+			CreateChild(window, leftEdge, A, C, IntersectRay(window.source, P0, A, C), IntersectRay(window.source, P1, A, C));
+			return;
+		}
+
+		// The opposite vertex is visible through the window, rays left of
+		// the crossing leave through the left edge and the rest through
+		// the right edge
+		double leftEnd = crossing;
+		double rightBegin = crossing;
+
+		double distance = distanceAt(C);
+		if (distance < m_Distances[c])
+		{
+			UpdateVertex(c, distance, halfEdge, crossing);
+		}
+		else if (m_EntryHalfEdge[c] == halfEdge)
+		{
+			// The shorter path to the vertex crossed this same edge, so it
+			// is a segment inside this face. Rays that would cross it are
+			// beaten by following it and are cut from the children
+			leftEnd = std::min(crossing, m_EntryCrossing[c]);
+			rightBegin = std::max(crossing, m_EntryCrossing[c]);
+		}
+
+		if (leftEnd > window.b0)
+		{
+			glm::dvec2 end = leftEnd == crossing ? C : IntersectRay(window.source, glm::dvec2(leftEnd, 0.0), A, C);
+			CreateChild(window, leftEdge, A, C, IntersectRay(window.source, P0, A, C), end);
+		}
+
+		if (rightBegin < window.b1)
+		{
+			glm::dvec2 begin = rightBegin == crossing ? C : IntersectRay(window.source, glm::dvec2(rightBegin, 0.0), C, B);
+			CreateChild(window, rightEdge, C, B, begin, IntersectRay(window.source, P1, C, B));
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+
+namespace GP
+{
+	// Exact polyhedral geodesic distances with the Improved Chen-Han (ICH)
+	// window propagation. A window is an interval of an edge whose shortest
+	// paths all come straight from one (pseudo) source unfolded into the
+	// plane of the face behind the edge. Windows are propagated across
+	// faces in order of their distance, and saddle or boundary vertices
+	// become new pseudo sources because shortest paths may bend there.
+	//
+	// Two rules of Xin and Wang keep the number of windows practical:
+	//   - a window is dropped when a vertex of the face it enters already
+	//     gives a shorter path to every point of the window, and cut
+	//     back where a source vertex of its edge is shorter
+	//   - when a window does not improve the vertex opposite to its edge
+	//     and the shortest path to that vertex crossed the same edge, only
+	//     the child on its own side of that path is kept
+	class ExactGeodesicSolver
+	{
+	public:
+		ExactGeodesicSolver(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices);
+
+		// Topology is taken from the half-edge mesh once, only lengths
+		// and the pseudo source flags change with the vertices
+		void UpdateGeometry(const std::vector<glm::vec3>& vertices);
+
+		// Single source distances to every vertex, written to outDistances
+		// when it is not null and to GetDistances otherwise
+		void ComputeDistances(uint32_t source, float* outDistances = nullptr);
+
+		const std::vector<float>& GetDistances() const { return m_Result; }
+
+		// Statistics of the last ComputeDistances call
+		uint64_t GetWindowCount() const { return m_WindowCount; }
+		uint64_t GetPrunedCount() const { return m_PrunedCount; }
+
+	private:
+		// Interval [b0, b1] on a half-edge, measured from its origin. The
+		// window enters the face of the half-edge, which lies on the +y
+		// side of the edge frame, and its source is at (sx, sy), sy <= 0
+		struct Window
+		{
+			uint32_t halfEdge;
+			double b0, b1;
+			glm::dvec2 source;
+			double sigma;
+		};
+
+		// Events only reference their window so the heap moves small
+		// entries, popped windows return their slot to the free list and
+		// memory follows the size of the propagation front rather than
+		// the number of windows created
+		struct Event
+		{
+			double key;
+			uint32_t vertex;
+			uint32_t window;
+		};
+
+		// 4-ary min heap like IndexedMinHeap, the front holds millions of
+		// events on 100k-face meshes and four 16 byte children share a
+		// cache line
+		void PushEvent(const Event& event);
+		Event PopEvent();
+
+		void PropagateWindow(Window window);
+		void PropagateVertex(uint32_t vertex);
+
+		void CreateWindow(uint32_t halfEdge, double b0, double b1, const glm::dvec2& source, double sigma);
+
+		// Child of a window on an edge of the face it is crossing. from
+		// and to are points of the edge in the frame of the parent
+		void CreateChild(const Window& parent, uint32_t edge, const glm::dvec2& edgeOrigin,
+			             const glm::dvec2& edgeTarget, const glm::dvec2& from, const glm::dvec2& to);
+
+		void UpdateVertex(uint32_t vertex, double distance, uint32_t halfEdge, double crossing);
+
+		// Cuts the parts of [b0, b1] where a path through an endpoint of
+		// the edge is shorter, returns false when nothing is left
+		bool TrimWindow(uint32_t halfEdge, double& b0, double& b1, const glm::dvec2& source, double sigma) const;
+
+		// Third corner of the face of a half-edge in the frame of that
+		// half-edge (origin at (0, 0), target at (length, 0))
+		glm::dvec2 GetOppositeCorner(uint32_t halfEdge) const;
+
+	private:
+		const HalfEdgeMesh& m_Mesh;
+
+		std::vector<double> m_EdgeLengths;
+		std::vector<char> m_PseudoSource;
+
+		// Current distance estimate of every vertex together with the
+		// half-edge and the position on it where its path entered the
+		// last face, used by the one angle one split rule
+		std::vector<double> m_Distances;
+		std::vector<uint32_t> m_EntryHalfEdge;
+		std::vector<double> m_EntryCrossing;
+
+		std::vector<Event> m_Queue;
+		std::vector<Window> m_Windows;
+		std::vector<uint32_t> m_FreeWindows;
+
+		std::vector<float> m_Result;
+
+		uint64_t m_WindowCount = 0;
+		uint64_t m_PrunedCount = 0;
+	};
+}
@@ -0,0 +1,85 @@
+#include <Precomp.h>
+#include <MeshOperations/FarthestPointSampler.h>
+
+#include <GeoProcess/System/Utils/ParallelFor.h>
+
+namespace GP
+{
+	// Below this many vertices per thread the argmax is not worth
+	// starting threads for
+	static const uint32_t MIN_VERTICES_PER_THREAD = 1 << 15;
+
+	FarthestPointSampler::FarthestPointSampler(const VertexAdjacency& adjacency)
+		: m_Adjacency(adjacency), m_Solver(adjacency)
+	{
+	}
+
+	std::vector<uint32_t> FarthestPointSampler::Sample(uint32_t sampleCount, uint32_t seed, float maxRadius)
+	{
+		std::vector<uint32_t> samples;
+
+		uint32_t vertexCount = m_Adjacency.GetVertexCount();
+		if (vertexCount == 0)
+			return samples;
+
+		sampleCount = std::min(sampleCount, vertexCount);
+		samples.reserve(sampleCount);
+
+		m_MinDistances.assign(vertexCount, std::numeric_limits<float>::max());
+		m_SettledCount = 0;
+
+		std::mt19937 generator(seed);
+		uint32_t next = std::uniform_int_distribution<uint32_t>(0, vertexCount - 1)(generator);
+
+		while (samples.size() < sampleCount)
+		{
+			samples.push_back(next);
+			m_SettledCount += m_Solver.UpdateMinDistances(next, m_MinDistances.data(), maxRadius);
+
+			if (samples.size() == sampleCount)
+				break;
+
+			next = FindFarthest();
+
+			// Every remaining vertex is a sample or cannot be reached
+			if (m_MinDistances[next] == 0.0f)
+				break;
+		}
+
+		return samples;
+	}
+
+	uint32_t FarthestPointSampler::FindFarthest() const
+	{
+		uint32_t vertexCount = (uint32_t)m_MinDistances.size();
+
+		// One slot per ParallelFor range, found from the range start
+		uint32_t chunkCount = GetParallelChunkCount(vertexCount, MIN_VERTICES_PER_THREAD);
+		uint32_t chunkSize = (vertexCount + chunkCount - 1) / chunkCount;
+		std::vector<uint32_t> chunkFarthest(chunkCount, 0);
+
+		ParallelFor(vertexCount, [&](uint32_t begin, uint32_t end)
+		{
+			uint32_t farthest = begin;
+			for (uint32_t i = begin + 1; i < end; i++)
+			{
+				if (m_MinDistances[i] > m_MinDistances[farthest])
+					farthest = i;
+			}
+
+			chunkFarthest[begin / chunkSize] = farthest;
+		}, MIN_VERTICES_PER_THREAD);
+
+		// Chunks are merged in order, a later chunk only wins with a
+		// strictly larger distance
+		uint32_t farthest = chunkFarthest[0];
+		for (uint32_t t = 1; t < chunkCount; t++)
+		{
+			uint32_t candidate = chunkFarthest[t];
+			if (m_MinDistances[candidate] > m_MinDistances[farthest])
+				farthest = candidate;
+		}
+
+		return farthest;
+	}
+}
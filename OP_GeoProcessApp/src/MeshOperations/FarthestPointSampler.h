@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#include <GeoProcess/System/Geometry/VertexAdjacency.h>
+
+#include <MeshOperations/GeodesicSolver.h>
+
+namespace GP
+{
+	// Farthest point sampling over the edge graph of a mesh. Every vertex
+	// keeps its distance to the closest sample so far; a new sample is the
+	// vertex with the largest such distance and only one Dijkstra search
+	// from it is needed to bring the array up to date. That search stops
+	// where the new sample is no longer the closest one, so later samples
+	// touch smaller and smaller regions of the mesh.
+	class FarthestPointSampler
+	{
+	public:
+		FarthestPointSampler(const VertexAdjacency& adjacency);
+
+		// The first sample is drawn from a generator seeded with seed, so
+		// the same seed always gives the same samples. Searches are
+		// limited to maxRadius around each sample, distances beyond it
+		// are approximate
+		std::vector<uint32_t> Sample(uint32_t sampleCount, uint32_t seed = 0,
+			                         float maxRadius = std::numeric_limits<float>::max());
+
+		// Distance of every vertex to its closest sample
+		const std::vector<float>& GetMinDistances() const { return m_MinDistances; }
+
+		// Vertices settled by all searches of the last Sample call
+		uint64_t GetSettledCount() const { return m_SettledCount; }
+
+	private:
+		// Index of the largest min distance, ties go to the lowest index
+		// so the result does not depend on the number of threads
+		uint32_t FindFarthest() const;
+
+	private:
+		const VertexAdjacency& m_Adjacency;
+		DijkstraSolver m_Solver;
+
+		std::vector<float> m_MinDistances;
+		uint64_t m_SettledCount = 0;
+	};
+}
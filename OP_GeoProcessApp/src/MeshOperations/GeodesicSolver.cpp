@@ -0,0 +1,269 @@
+#include <Precomp.h>
+#include <MeshOperations/GeodesicSolver.h>
+
+namespace GP
+{
+	DijkstraSolver::DijkstraSolver(const VertexAdjacency& adjacency) : m_Adjacency(adjacency)
+	{
+		m_Distances.resize(m_Adjacency.GetVertexCount());
+		m_Previous.resize(m_Adjacency.GetVertexCount());
+		m_Heap.Resize(m_Adjacency.GetVertexCount());
+	}
+
+	DijkstraSolver::DijkstraSolver(const VertexAdjacency& adjacency, const std::vector<glm::vec3>& positions)
+		: DijkstraSolver(adjacency)
+	{
+		m_Positions = &positions;
+	}
+
+	void DijkstraSolver::PathSearch::Resize(uint32_t vertexCount)
+	{
+		distances.assign(vertexCount, std::numeric_limits<float>::max());
+		previous.assign(vertexCount, (uint32_t)-1);
+		touched.clear();
+		heap.Resize(vertexCount);
+	}
+
+	void DijkstraSolver::PathSearch::Reset()
+	{
+		for (uint32_t vertex : touched)
+		{
+			distances[vertex] = std::numeric_limits<float>::max();
+			previous[vertex] = (uint32_t)-1;
+		}
+
+		touched.clear();
+		heap.Clear();
+	}
+
+	void DijkstraSolver::PathSearch::Relax(uint32_t vertex, uint32_t from, float distance, float key)
+	{
+		if (distances[vertex] == std::numeric_limits<float>::max())
+			touched.push_back(vertex);
+
+		distances[vertex] = distance;
+		previous[vertex] = from;
+		heap.PushOrDecrease(vertex, key);
+	}
+
+	void DijkstraSolver::Reset(float* distances)
+	{
+		std::fill(distances, distances + m_Distances.size(), std::numeric_limits<float>::max());
+		std::fill(m_Previous.begin(), m_Previous.end(), (uint32_t)-1);
+		m_Heap.Clear();
+	}
+
+	void DijkstraSolver::ComputeDistances(uint32_t source, float* outDistances)
+	{
+		float* distances = outDistances ? outDistances : m_Distances.data();
+
+		Reset(distances);
+
+		// Every vertex is in the heap at most once, improving an
+		// estimate moves the vertex up instead of pushing a copy
+		distances[source] = 0.0f;
+		m_Heap.Push(source, 0.0f);
+
+		while (!m_Heap.Empty())
+		{
+			float currentDistance = m_Heap.TopKey();
+			uint32_t current = m_Heap.Pop();
+
+			for (uint32_t e = m_Adjacency.Begin(current); e < m_Adjacency.End(current); e++)
+			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
+				float distance = currentDistance + m_Adjacency.GetEdgeLength(e);
+
+				if (distance < distances[neighbor])
+				{
+					distances[neighbor] = distance;
+					m_Previous[neighbor] = current;
+					m_Heap.PushOrDecrease(neighbor, distance);
+				}
+			}
+		}
+	}
+
+	uint32_t DijkstraSolver::UpdateMinDistances(uint32_t source, float* minDistances, float maxRadius)
+	{
+		// minDistances already holds shortest distances to the earlier
+		// sources and satisfies the triangle inequality, so a vertex that
+		// is not improved cannot lead to one that is and the search is
+		// exact without visiting the rest of the mesh
+		m_Heap.Clear();
+		minDistances[source] = 0.0f;
+		m_Heap.Push(source, 0.0f);
+
+		uint32_t settled = 0;
+
+		while (!m_Heap.Empty())
+		{
+			float currentDistance = m_Heap.TopKey();
+			uint32_t current = m_Heap.Pop();
+			settled++;
+
+			if (currentDistance > maxRadius)
+				continue;
+
+			for (uint32_t e = m_Adjacency.Begin(current); e < m_Adjacency.End(current); e++)
+			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
+				float distance = currentDistance + m_Adjacency.GetEdgeLength(e);
+
+				if (distance < minDistances[neighbor])
+				{
+					minDistances[neighbor] = distance;
+					m_Heap.PushOrDecrease(neighbor, distance);
+				}
+			}
+		}
+
+		return settled;
+	}
+
+	float DijkstraSolver::ComputePath(uint32_t source, uint32_t target, PathQueryMode mode, std::vector<uint32_t>& outPath)
+	{
+		outPath.clear();
+		m_SettledCount = 0;
+
+		float distance = std::numeric_limits<float>::max();
+
+		if (mode == PathQueryMode::FULL)
+		{
+			ComputeDistances(source);
+			m_SettledCount = m_Adjacency.GetVertexCount();
+
+			distance = m_Distances[target];
+			if (distance == std::numeric_limits<float>::max())
+				return distance;
+
+			for (uint32_t v = target; v != (uint32_t)-1; v = m_Previous[v])
+				outPath.push_back(v);
+
+			std::reverse(outPath.begin(), outPath.end());
+			return distance;
+		}
+
+		// Arrays are sized on first use so solvers that only compute
+		// full rows do not pay for them
+		if (m_Forward.distances.size() != m_Adjacency.GetVertexCount())
+		{
+			m_Forward.Resize(m_Adjacency.GetVertexCount());
+			m_Backward.Resize(m_Adjacency.GetVertexCount());
+		}
+
+		m_Forward.Reset();
+		m_Backward.Reset();
+
+		uint32_t meetForward = target;
+		uint32_t meetBackward = (uint32_t)-1;
+
+		if (mode == PathQueryMode::BIDIRECTIONAL)
+			distance = SearchBidirectional(source, target, meetForward, meetBackward);
+		else
+			distance = SearchToTarget(source, target, mode == PathQueryMode::ASTAR && m_Positions);
+
+		if (distance == std::numeric_limits<float>::max())
+			return distance;
+
+		// Forward half is collected backwards from the meeting vertex,
+		// the backward search already points towards the target
+		for (uint32_t v = meetForward; v != (uint32_t)-1; v = m_Forward.previous[v])
+			outPath.push_back(v);
+
+		std::reverse(outPath.begin(), outPath.end());
+
+		for (uint32_t v = meetBackward; v != (uint32_t)-1; v = m_Backward.previous[v])
+			outPath.push_back(v);
+
+		return distance;
+	}
+
+	float DijkstraSolver::SearchToTarget(uint32_t source, uint32_t target, bool useHeuristic)
+	{
+		const glm::vec3 targetPosition = useHeuristic ? (*m_Positions)[target] : glm::vec3(0.0f);
+
+		// Keys are distance + heuristic, the heuristic of a vertex never
+		// changes so decrease-key still holds
+		auto heuristic = [&](uint32_t vertex)
+		{
+			return useHeuristic ? glm::length((*m_Positions)[vertex] - targetPosition) : 0.0f;
+		};
+
+		m_Forward.Relax(source, (uint32_t)-1, 0.0f, heuristic(source));
+
+		while (!m_Forward.heap.Empty())
+		{
+			uint32_t current = m_Forward.heap.Pop();
+			m_SettledCount++;
+
+			if (current == target)
+				return m_Forward.distances[target];
+
+			float currentDistance = m_Forward.distances[current];
+
+			for (uint32_t e = m_Adjacency.Begin(current); e < m_Adjacency.End(current); e++)
+			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
+				float distance = currentDistance + m_Adjacency.GetEdgeLength(e);
+
+				if (distance < m_Forward.distances[neighbor])
+					m_Forward.Relax(neighbor, current, distance, distance + heuristic(neighbor));
+			}
+		}
+
+		return std::numeric_limits<float>::max();
+	}
+
+	float DijkstraSolver::SearchBidirectional(uint32_t source, uint32_t target, uint32_t& meetForward, uint32_t& meetBackward)
+	{
+		m_Forward.Relax(source, (uint32_t)-1, 0.0f, 0.0f);
+		m_Backward.Relax(target, (uint32_t)-1, 0.0f, 0.0f);
+
+		meetForward = source;
+		meetBackward = source == target ? (uint32_t)-1 : target;
+
+		if (source == target)
+			return 0.0f;
+
+		// Length of the best path seen through an edge between the
+		// two searches
+		float best = std::numeric_limits<float>::max();
+
+		while (!m_Forward.heap.Empty() && !m_Backward.heap.Empty())
+		{
+			// No path through unsettled vertices can be shorter any more
+			if (m_Forward.heap.TopKey() + m_Backward.heap.TopKey() >= best)
+				break;
+
+			// Expand the side with the smaller frontier key, the mesh
+			// is undirected so both use the same adjacency
+			bool forward = m_Forward.heap.TopKey() <= m_Backward.heap.TopKey();
+			PathSearch& search = forward ? m_Forward : m_Backward;
+			PathSearch& other = forward ? m_Backward : m_Forward;
+
+			float currentDistance = search.heap.TopKey();
+			uint32_t current = search.heap.Pop();
+			m_SettledCount++;
+
+			for (uint32_t e = m_Adjacency.Begin(current); e < m_Adjacency.End(current); e++)
+			{
+				uint32_t neighbor = m_Adjacency.GetNeighbor(e);
+				float distance = currentDistance + m_Adjacency.GetEdgeLength(e);
+
+				if (distance < search.distances[neighbor])
+					search.Relax(neighbor, current, distance, distance);
+
+				if (other.distances[neighbor] != std::numeric_limits<float>::max() &&
+					distance + other.distances[neighbor] < best)
+				{
+					best = distance + other.distances[neighbor];
+					meetForward = forward ? current : neighbor;
+					meetBackward = forward ? neighbor : current;
+				}
+			}
+		}
+
+		return best;
+	}
+}
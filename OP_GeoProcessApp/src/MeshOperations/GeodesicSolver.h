@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include <GeoProcess/System/Geometry/VertexAdjacency.h>
+
+#include <MeshOperations/IndexedHeap.h>
+
+namespace GP
+{
+	enum class PathQueryMode
+	{
+		// Single source search over the whole mesh
+		FULL = 0,
+		// Dijkstra that stops as soon as the target is settled
+		EARLY_EXIT = 1,
+		// Searches from both ends until the frontiers meet
+		BIDIRECTIONAL = 2,
+		// Early exit guided by the straight line distance to the target
+		ASTAR = 3
+	};
+
+	// Dijkstra's shortest paths over the edge graph of a mesh. All per-query
+	// state (distances, predecessors and the heap) lives in dense arrays
+	// owned by the solver while the adjacency is only read, so every worker
+	// thread can create its own solver over the same mesh.
+	class DijkstraSolver
+	{
+	public:
+		DijkstraSolver(const VertexAdjacency& adjacency);
+
+		// Positions are only needed by PathQueryMode::ASTAR. Edge lengths
+		// are Euclidean, so the straight line distance never overestimates
+		// and the heuristic is admissible
+		DijkstraSolver(const VertexAdjacency& adjacency, const std::vector<glm::vec3>& positions);
+
+		// Single source distances to every vertex. If outDistances is not
+		// null the search runs directly in that array (e.g. a preallocated
+		// matrix row) and GetDistances is left untouched
+		void ComputeDistances(uint32_t source, float* outDistances = nullptr);
+
+		// Lowers minDistances to the distances from source wherever the new
+		// source is closer. The search never leaves the region the source
+		// improves, which shrinks as more sources are added (e.g. farthest
+		// point sampling). Vertices farther than maxRadius are not expanded.
+		// Returns the number of settled vertices
+		uint32_t UpdateMinDistances(uint32_t source, float* minDistances,
+			                        float maxRadius = std::numeric_limits<float>::max());
+
+		// Shortest path between two vertices, outPath goes from source to
+		// target. Only the vertices reached by the search are reset for the
+		// next query, so a short path on a large mesh stays cheap. Returns
+		// the path length or float max if target cannot be reached
+		float ComputePath(uint32_t source, uint32_t target, PathQueryMode mode, std::vector<uint32_t>& outPath);
+
+		const std::vector<float>& GetDistances() const { return m_Distances; }
+		const std::vector<uint32_t>& GetPrevious() const { return m_Previous; }
+
+		// Vertices settled by the last ComputePath call
+		uint32_t GetSettledCount() const { return m_SettledCount; }
+
+	private:
+		// State of one search direction of a point to point query, the
+		// arrays stay at their initial values except for touched vertices
+		struct PathSearch
+		{
+			std::vector<float> distances;
+			std::vector<uint32_t> previous;
+			std::vector<uint32_t> touched;
+			IndexedMinHeap heap;
+
+			void Resize(uint32_t vertexCount);
+			void Reset();
+			void Relax(uint32_t vertex, uint32_t from, float distance, float key);
+		};
+
+		void Reset(float* distances);
+
+		float SearchToTarget(uint32_t source, uint32_t target, bool useHeuristic);
+		float SearchBidirectional(uint32_t source, uint32_t target, uint32_t& meetForward, uint32_t& meetBackward);
+
+	private:
+		const VertexAdjacency& m_Adjacency;
+		const std::vector<glm::vec3>* m_Positions = nullptr;
+
+		PathSearch m_Forward;
+		PathSearch m_Backward;
+		uint32_t m_SettledCount = 0;
+
+		std::vector<float> m_Distances;
+		std::vector<uint32_t> m_Previous;
+		IndexedMinHeap m_Heap;
+	};
+}
@@ -0,0 +1,173 @@
+#include <Precomp.h>
+#include <MeshOperations/HeatGeodesicSolver.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+
+namespace GP
+{
+	namespace
+	{
+		// Sources solved together, large enough for the solves to work on
+		// a dense block and small enough to keep every core busy
+		const uint32_t BLOCK_SIZE = 32;
+	}
+
+	HeatGeodesicSolver::HeatGeodesicSolver(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices, double timeFactor)
+	{
+		Timer timer;
+
+		m_VertexCount = mesh.GetVertexCount();
+		m_Indices = mesh.GetIndices();
+		m_Distances.resize(m_VertexCount);
+
+		uint32_t faceCount = mesh.GetFaceCount();
+		m_Gradients.resize(faceCount * 3);
+
+		// Cotangent Laplacian and lumped mass come from the shared builder,
+		// only the hat function gradients are specific to the heat method
+		LaplacianBuilder builder(mesh);
+		builder.SetPositions(vertices);
+
+		const SparseMatrix& laplacian = builder.GetLaplacian(LaplacianType::COTANGENT);
+		const SparseMatrix& massMatrix = builder.GetMassMatrix(MassType::LUMPED);
+		m_FaceAreas = builder.GetFaceAreas();
+
+		for (uint32_t f = 0; f < faceCount; f++)
+		{
+			uint32_t v[3] = { m_Indices[f * 3], m_Indices[f * 3 + 1], m_Indices[f * 3 + 2] };
+			glm::dvec3 p[3] = { glm::dvec3(vertices[v[0]]), glm::dvec3(vertices[v[1]]), glm::dvec3(vertices[v[2]]) };
+
+			glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+			double doubleArea = glm::length(normal);
+
+			if (doubleArea <= 0.0)
+			{
+				for (uint32_t i = 0; i < 3; i++)
+					m_Gradients[f * 3 + i] = glm::dvec3(0.0);
+
+				continue;
+			}
+
+			normal = normal / doubleArea;
+
+			// Gradient of the hat function of corner i, perpendicular
+			// to the opposite edge inside the face
+			for (uint32_t i = 0; i < 3; i++)
+				m_Gradients[f * 3 + i] = glm::cross(normal, p[(i + 2) % 3] - p[(i + 1) % 3]) / doubleArea;
+		}
+
+		double meanEdgeLength = builder.GetMeanEdgeLength();
+		double t = timeFactor * meanEdgeLength * meanEdgeLength;
+
+		m_HeatSolver.compute(massMatrix + t * laplacian);
+
+		// L only determines distances up to a constant, a tiny multiple of
+		// M makes it definite without changing the gradients noticeably
+		m_PoissonSolver.compute(laplacian + 1e-8 * massMatrix);
+
+		m_Valid = m_HeatSolver.info() == Eigen::Success && m_PoissonSolver.info() == Eigen::Success;
+		if (!m_Valid)
+			GP_ERROR("Heat method factorization failed");
+
+		m_FactorizationTime = timer.ElapsedMilliseconds();
+	}
+
+	Ref<HeatGeodesicSolver> HeatGeodesicSolver::Create(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices, double timeFactor)
+	{
+		return std::make_shared<HeatGeodesicSolver>(mesh, vertices, timeFactor);
+	}
+
+	bool HeatGeodesicSolver::ComputeDistances(uint32_t source, float* outDistances)
+	{
+		return SolveBlock(&source, 1, outDistances ? outDistances : m_Distances.data());
+	}
+
+	bool HeatGeodesicSolver::ComputeDistances(const std::vector<uint32_t>& sources, float* outDistances) const
+	{
+		uint32_t blockCount = (sources.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		uint32_t threadCount = std::min(blockCount, std::max(1u, std::thread::hardware_concurrency()));
+
+		std::atomic<uint32_t> nextBlock = 0;
+		std::atomic<bool> solved = true;
+		std::vector<std::future<void>> futures;
+
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			futures.push_back(std::async(std::launch::async, [&]()
+				{
+					uint32_t block;
+					while ((block = nextBlock++) < blockCount)
+					{
+						uint32_t first = block * BLOCK_SIZE;
+						uint32_t count = std::min(BLOCK_SIZE, (uint32_t)sources.size() - first);
+
+						if (!SolveBlock(sources.data() + first, count, outDistances + (uint64_t)first * m_VertexCount))
+							solved = false;
+					}
+				}
+			));
+		}
+
+		for (auto& future : futures)
+			future.wait();
+
+		return solved;
+	}
+
+	bool HeatGeodesicSolver::SolveBlock(const uint32_t* sources, uint32_t count, float* outDistances) const
+	{
+		// Callers may write the rows out, they must not be left untouched
+		if (!m_Valid)
+		{
+			std::fill(outDistances, outDistances + (uint64_t)count * m_VertexCount, std::numeric_limits<float>::infinity());
+			return false;
+		}
+
+		// Heat flow from a unit impulse at every source
+		Eigen::MatrixXd impulses = Eigen::MatrixXd::Zero(m_VertexCount, count);
+		for (uint32_t k = 0; k < count; k++)
+			impulses(sources[k], k) = 1.0;
+
+		Eigen::MatrixXd heat = m_HeatSolver.solve(impulses);
+
+		// Integrated divergence of the normalized field X = -grad u / |grad u|,
+		// the right hand side of the Poisson equation L phi = div X
+		Eigen::MatrixXd divergence = Eigen::MatrixXd::Zero(m_VertexCount, count);
+
+		uint32_t faceCount = (uint32_t)m_FaceAreas.size();
+		for (uint32_t f = 0; f < faceCount; f++)
+		{
+			const uint32_t* v = &m_Indices[f * 3];
+			const glm::dvec3* g = &m_Gradients[f * 3];
+
+			for (uint32_t k = 0; k < count; k++)
+			{
+				glm::dvec3 gradient = g[0] * heat(v[0], k) + g[1] * heat(v[1], k) + g[2] * heat(v[2], k);
+
+				double length = glm::length(gradient);
+				if (length <= 0.0)
+					continue;
+
+				glm::dvec3 field = gradient * (-m_FaceAreas[f] / length);
+
+				divergence(v[0], k) += glm::dot(field, g[0]);
+				divergence(v[1], k) += glm::dot(field, g[1]);
+				divergence(v[2], k) += glm::dot(field, g[2]);
+			}
+		}
+
+		Eigen::MatrixXd phi = m_PoissonSolver.solve(divergence);
+
+		// Distances are relative to the value at the source
+		for (uint32_t k = 0; k < count; k++)
+		{
+			double offset = phi(sources[k], k);
+			float* row = outDistances + (uint64_t)k * m_VertexCount;
+
+			for (uint32_t v = 0; v < m_VertexCount; v++)
+				row[v] = (float)std::max(0.0, phi(v, k) - offset);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+#include <GeoProcess/System/Geometry/LaplacianBuilder.h>
+
+namespace GP
+{
+	// Geodesic distances with the heat method (Crane et al.): heat is
+	// diffused from the source for a short time t, its normalized gradient
+	// gives the direction of the distance field and a Poisson equation
+	// turns that field back into distances.
+	//
+	// Both systems only depend on the mesh, so the cotangent Laplacian and
+	// the mass matrix are factorized once with SimplicialLDLT and every
+	// source afterwards costs two back substitutions. Several sources are
+	// solved together as columns of one right hand side.
+	class HeatGeodesicSolver
+	{
+	public:
+		// t = timeFactor * h^2 where h is the mean edge length
+		HeatGeodesicSolver(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices, double timeFactor = 1.0);
+
+		static Ref<HeatGeodesicSolver> Create(const HalfEdgeMesh& mesh, const std::vector<glm::vec3>& vertices, double timeFactor = 1.0);
+
+		bool IsValid() const { return m_Valid; }
+
+		// Both return false when the factorization failed, the output
+		// is then filled with infinity
+		bool ComputeDistances(uint32_t source, float* outDistances = nullptr);
+
+		// Row i of outDistances (sources.size() x N) receives the distances
+		// from sources[i]. Sources are solved in blocks and the blocks are
+		// spread over all cores, the factorizations are shared read-only
+		bool ComputeDistances(const std::vector<uint32_t>& sources, float* outDistances) const;
+
+		const std::vector<float>& GetDistances() const { return m_Distances; }
+
+		float GetFactorizationTime() const { return m_FactorizationTime; }
+
+	private:
+		bool SolveBlock(const uint32_t* sources, uint32_t count, float* outDistances) const;
+
+	private:
+		typedef LaplacianBuilder::SparseMatrix SparseMatrix;
+
+		uint32_t m_VertexCount = 0;
+		std::vector<uint32_t> m_Indices;
+
+		// Gradients of the three hat functions of every face, the gradient
+		// of a piecewise linear function is their weighted sum
+		std::vector<glm::dvec3> m_Gradients;
+		std::vector<double> m_FaceAreas;
+
+		// (M + t L) for the heat flow and L for the Poisson step
+		Eigen::SimplicialLDLT<SparseMatrix> m_HeatSolver;
+		Eigen::SimplicialLDLT<SparseMatrix> m_PoissonSolver;
+
+		std::vector<float> m_Distances;
+		float m_FactorizationTime = 0.0f;
+		bool m_Valid = false;
+	};
+}
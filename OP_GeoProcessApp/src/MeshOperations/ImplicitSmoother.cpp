@@ -0,0 +1,98 @@
+#include <Precomp.h>
+#include <MeshOperations/ImplicitSmoother.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+
+namespace GP
+{
+	ImplicitSmoother::ImplicitSmoother(const HalfEdgeMesh& topology)
+		: m_Builder(topology)
+	{
+	}
+
+	Ref<ImplicitSmoother> ImplicitSmoother::Create(const HalfEdgeMesh& topology)
+	{
+		return std::make_shared<ImplicitSmoother>(topology);
+	}
+
+	bool ImplicitSmoother::Smooth(std::vector<glm::vec3>& vertices, const SmoothingSpecs& specs)
+	{
+		if (specs.mode == SmoothingMode::EXPLICIT)
+			return false;
+
+		Timer timer;
+
+		uint32_t vertexCount = (uint32_t)vertices.size();
+
+		Eigen::MatrixX3d positions(vertexCount, 3);
+		for (uint32_t i = 0; i < vertexCount; i++)
+			positions.row(i) = Eigen::RowVector3d(vertices[i].x, vertices[i].y, vertices[i].z);
+
+		for (uint32_t iteration = 0; iteration < specs.iterations; iteration++)
+		{
+			bool followSurface = specs.mode == SmoothingMode::MEAN_CURVATURE_FLOW;
+
+			if (!m_OperatorBuilt || followSurface)
+			{
+				// The first iteration still has the input positions
+				if (iteration > 0)
+				{
+					for (uint32_t i = 0; i < vertexCount; i++)
+						vertices[i] = glm::vec3(positions(i, 0), positions(i, 1), positions(i, 2));
+				}
+
+				m_Builder.SetPositions(vertices);
+				m_OperatorBuilt = true;
+				m_Factorized = false;
+			}
+
+			if (!m_Factorized || m_FactorizedStepSize != specs.stepSize || m_FactorizedLaplacian != specs.laplacian)
+			{
+				if (!Factorize(specs))
+					return false;
+			}
+
+			const SparseMatrix& mass = m_Builder.GetMassMatrix(MassType::LUMPED);
+			positions = m_Solver.solve(mass * positions);
+		}
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+			vertices[i] = glm::vec3(positions(i, 0), positions(i, 1), positions(i, 2));
+
+		GP_TRACE("{0} smoothing steps took {1} ms, {2} factorizations so far", specs.iterations,
+			timer.ElapsedMilliseconds(), m_FactorizationCount);
+
+		return true;
+	}
+
+	bool ImplicitSmoother::Factorize(const SmoothingSpecs& specs)
+	{
+		double meanEdgeLength = m_Builder.GetMeanEdgeLength();
+		double lambda = specs.stepSize * meanEdgeLength * meanEdgeLength;
+
+		SparseMatrix system = m_Builder.GetMassMatrix(MassType::LUMPED) + lambda * m_Builder.GetLaplacian(specs.laplacian);
+
+		// Every Laplacian has the adjacency pattern, only the values change
+		if (!m_PatternAnalyzed)
+		{
+			m_Solver.analyzePattern(system);
+			m_PatternAnalyzed = true;
+		}
+
+		m_Solver.factorize(system);
+
+		m_FactorizationCount++;
+
+		if (m_Solver.info() != Eigen::Success)
+		{
+			GP_ERROR("Smoothing system could not be factorized");
+			m_Factorized = false;
+			return false;
+		}
+
+		m_Factorized = true;
+		m_FactorizedStepSize = specs.stepSize;
+		m_FactorizedLaplacian = specs.laplacian;
+		return true;
+	}
+}
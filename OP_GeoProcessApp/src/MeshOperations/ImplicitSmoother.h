@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+#include <GeoProcess/System/Geometry/LaplacianBuilder.h>
+
+namespace GP
+{
+	enum class SmoothingMode
+	{
+		// Every vertex moves a fixed distance towards each neighbor
+		EXPLICIT = 0,
+		// Laplacian and mass of the mesh at the first step are kept, so
+		// the factorization is reused by every following step
+		IMPLICIT = 1,
+		// Operators follow the surface, every step refactorizes
+		MEAN_CURVATURE_FLOW = 2
+	};
+
+	struct SmoothingSpecs
+	{
+		SmoothingMode mode = SmoothingMode::IMPLICIT;
+		LaplacianType laplacian = LaplacianType::COTANGENT;
+
+		// lambda in units of the squared mean edge length, so the same
+		// value smooths meshes of any scale by the same amount
+		float stepSize = 1.0f;
+		uint32_t iterations = 1;
+	};
+
+	// Implicit (backward Euler) Laplacian smoothing, every step solves
+	// (M + lambda L) x = M x0 for the three coordinates at once. L is the
+	// positive semi-definite Laplacian of LaplacianBuilder, so this is the
+	// usual (M - lambda L) with the opposite sign convention. Steps of any
+	// size are stable and cost one back substitution while the operator
+	// stays the same. The sparsity pattern never changes, so it is only
+	// analyzed once even when the values are refactorized.
+	class ImplicitSmoother
+	{
+	public:
+		// The topology has to outlive the smoother
+		ImplicitSmoother(const HalfEdgeMesh& topology);
+
+		static Ref<ImplicitSmoother> Create(const HalfEdgeMesh& topology);
+
+		// Runs specs.iterations steps on vertices, returns false if the
+		// system could not be factorized
+		bool Smooth(std::vector<glm::vec3>& vertices, const SmoothingSpecs& specs);
+
+		// The next IMPLICIT step takes the operators from the current
+		// positions again
+		void ResetOperator() { m_OperatorBuilt = false; }
+
+		uint32_t GetFactorizationCount() const { return m_FactorizationCount; }
+
+	private:
+		bool Factorize(const SmoothingSpecs& specs);
+
+	private:
+		typedef LaplacianBuilder::SparseMatrix SparseMatrix;
+
+		LaplacianBuilder m_Builder;
+		Eigen::SimplicialLDLT<SparseMatrix> m_Solver;
+
+		bool m_PatternAnalyzed = false;
+		bool m_OperatorBuilt = false;
+		bool m_Factorized = false;
+
+		// What the current factorization was computed with
+		LaplacianType m_FactorizedLaplacian = LaplacianType::COTANGENT;
+		float m_FactorizedStepSize = 0.0f;
+
+		uint32_t m_FactorizationCount = 0;
+	};
+}
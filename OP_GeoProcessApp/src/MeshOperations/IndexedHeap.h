@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace GP
+{
+	// Indexed 4-ary min heap over the vertices of a mesh. Keys are stored
+	// next to the vertex inside the heap array and m_Positions maps every
+	// vertex to its slot, so decrease-key is a sift-up from a known position
+	// instead of a second copy of the vertex. A 4-ary heap is shallower than
+	// a binary one and the four children of a slot share a cache line.
+	class IndexedMinHeap
+	{
+	public:
+		static constexpr uint32_t ARITY = 4;
+		static constexpr uint32_t INVALID = (uint32_t)-1;
+
+		IndexedMinHeap() {}
+		IndexedMinHeap(uint32_t vertexCount) { Resize(vertexCount); }
+
+		void Resize(uint32_t vertexCount)
+		{
+			m_Positions.assign(vertexCount, INVALID);
+			m_Entries.clear();
+			m_Entries.reserve(vertexCount);
+		}
+
+		// Only the vertices still in the heap are touched, so clearing
+		// after a full Dijkstra run costs nothing
+		void Clear()
+		{
+			for (const Entry& entry : m_Entries)
+				m_Positions[entry.vertex] = INVALID;
+
+			m_Entries.clear();
+		}
+
+		bool Empty() const { return m_Entries.empty(); }
+		uint32_t Size() const { return (uint32_t)m_Entries.size(); }
+		bool Contains(uint32_t vertex) const { return m_Positions[vertex] != INVALID; }
+
+		uint32_t Top() const { return m_Entries[0].vertex; }
+		float TopKey() const { return m_Entries[0].key; }
+		float GetKey(uint32_t vertex) const { return m_Entries[m_Positions[vertex]].key; }
+
+		void Push(uint32_t vertex, float key)
+		{
+			m_Entries.push_back({ key, vertex });
+			SiftUp((uint32_t)m_Entries.size() - 1);
+		}
+
+		// key must not be larger than the current key of the vertex
+		void DecreaseKey(uint32_t vertex, float key)
+		{
+			uint32_t position = m_Positions[vertex];
+			m_Entries[position].key = key;
+			SiftUp(position);
+		}
+
+		// Inserts the vertex or lowers its key, returns false if the
+		// vertex is already in the heap with a key that is not larger
+		bool PushOrDecrease(uint32_t vertex, float key)
+		{
+			if (!Contains(vertex))
+			{
+				Push(vertex, key);
+				return true;
+			}
+
+			if (key < GetKey(vertex))
+			{
+				DecreaseKey(vertex, key);
+				return true;
+			}
+
+			return false;
+		}
+
+		uint32_t Pop()
+		{
+			uint32_t top = m_Entries[0].vertex;
+			m_Positions[top] = INVALID;
+
+			Entry last = m_Entries.back();
+			m_Entries.pop_back();
+
+			if (!m_Entries.empty())
+			{
+				m_Entries[0] = last;
+				m_Positions[last.vertex] = 0;
+				SiftDown(0);
+			}
+
+			return top;
+		}
+
+	private:
+		struct Entry
+		{
+			float key;
+			uint32_t vertex;
+		};
+
+		// Both sifts move a hole instead of swapping, the moving entry
+		// is written once at its final slot
+		void SiftUp(uint32_t position)
+		{
+			Entry entry = m_Entries[position];
+
+			while (position > 0)
+			{
+				uint32_t parent = (position - 1) / ARITY;
+				if (m_Entries[parent].key <= entry.key)
+					break;
+
+				m_Entries[position] = m_Entries[parent];
+				m_Positions[m_Entries[position].vertex] = position;
+				position = parent;
+			}
+
+			m_Entries[position] = entry;
+			m_Positions[entry.vertex] = position;
+		}
+
+		void SiftDown(uint32_t position)
+		{
+			Entry entry = m_Entries[position];
+			uint32_t size = (uint32_t)m_Entries.size();
+
+			while (true)
+			{
+				uint32_t first = position * ARITY + 1;
+				if (first >= size)
+					break;
+
+				uint32_t last = std::min(first + ARITY, size);
+				uint32_t smallest = first;
+				for (uint32_t child = first + 1; child < last; child++)
+				{
+					if (m_Entries[child].key < m_Entries[smallest].key)
+						smallest = child;
+				}
+
+				if (entry.key <= m_Entries[smallest].key)
+					break;
+
+				m_Entries[position] = m_Entries[smallest];
+				m_Positions[m_Entries[position].vertex] = position;
+				position = smallest;
+			}
+
+			m_Entries[position] = entry;
+			m_Positions[entry.vertex] = position;
+		}
+
+	private:
+		std::vector<Entry> m_Entries;
+		std::vector<uint32_t> m_Positions;
+	};
+}
@@ -1,81 +1,43 @@
 #include <Precomp.h>
 #include <MeshOperations/PCADatabase.h>
 
+#include <GeoProcess/System/Profiling/Timer.h>
+#include <GeoProcess/System/ResourceSystem/ResourceManager.h>
+
 namespace GP
 {
-	PCADatabase::PCADatabase(Ref<ModelDatabase> modelDB) : m_ModelDatabase(modelDB)
+	PCADatabase::PCADatabase(Ref<ModelDatabase> modelDB, const PCASpecs& specs) : m_ModelDatabase(modelDB), m_Specs(specs)
 	{
 		GP_TRACE("Size of database is: {0}", m_ModelDatabase->GetMeshCount());
 		m_Indices = m_ModelDatabase->GetIndices();
 
-		// Get mean vector
-		GP_TRACE("Mean Vector Calculation");
-		Eigen::MatrixXd mean = CalculateMeanVertices();
-		m_Mean = mean;
-
-		// Get Y Matrix
-		GP_TRACE("Y matrix Calculation");
-		Eigen::MatrixXd yMatrix = ConstructYMatrix(mean);
-
-		// Karhunen-Loeve Transform
-		GP_TRACE("Scatter Calculation");
-		Eigen::MatrixXd kScatter = yMatrix.transpose() * yMatrix;
-
-		// Construct matrix operation object using the wrapper class DenseSymMatProd
-		Spectra::DenseSymMatProd<double> op(kScatter);
-
-		GP_TRACE("EigenValue Calc");
-		int meshCount = m_ModelDatabase->GetMeshCount();
-		Spectra::SymEigsSolver<Spectra::DenseSymMatProd<double>> eigs(op, meshCount - 2,
-			                                                              meshCount);
-		eigs.init();
-		int nconv = eigs.compute(Spectra::SortRule::LargestAlge);
-
-		// Retrieve results
-		Eigen::VectorXd evalues;
-		Eigen::MatrixXd eigenVectors;
-		if (eigs.info() == Spectra::CompInfo::Successful)
-		{
-			evalues = eigs.eigenvalues();
-			eigenVectors = eigs.eigenvectors();
-		}
-
-		float evalueSum = evalues.sum();
-
-		std::cout << "Eigenvalues found:\n" << evalues << std::endl;
-		std::cout << "Eigenvectors\n" << eigenVectors.rows() << " " << eigenVectors.cols() << std::endl;
+		Timer timer;
 
+		m_Model = PCAModel::Create();
 
-		// Now compute real eigenvectors
-		float totalEvalue = 0.0f;
-		for (uint32_t i = 0; i < eigenVectors.cols(); i++)
+		// A saved model of these shapes is mapped and used as is, shapes
+		// streamed in after them with AddShapes are kept
+		const std::vector<MeshBlueprint>& meshes = m_ModelDatabase->GetMeshes();
+		std::filesystem::path path = GetModelPath();
+		if (m_Model->Load(path, meshes.data(), (uint32_t)meshes.size(), m_Specs))
 		{
-			float currentEvalue = evalues(i);
-			totalEvalue += currentEvalue;
-
-			if (totalEvalue / evalueSum >= 0.9)
-				break;
-
-			m_Eigenvectors.push_back(yMatrix * eigenVectors.col(i));
-			m_Coeffs.push_back(0.0f);
+			GP_TRACE("Loaded PCA model from {0} in {1} ms", path.string(), timer.ElapsedMilliseconds());
 		}
-
-		GP_TRACE("MeanSize is {0},{1}", mean.rows(), mean.cols());
-		GP_TRACE("YmatrixSize is {0},{1}", yMatrix.rows(), yMatrix.cols());
-
-
-		// Calculate new vertices
-		Eigen::MatrixXd x = m_Mean;
-		for (uint32_t i = 0; i < m_Eigenvectors.size(); i++)
+		else
 		{
-			x += m_Eigenvectors[i] * m_Coeffs[i];
-		}
+			// Shapes are streamed in batches of specs.batchSize, so only one
+			// batch is ever held as a dense matrix
+			m_Model = PCAModel::Create();
+			m_Model->AddShapes(meshes.data(), (uint32_t)meshes.size(), m_Specs);
+			m_Model->Save(path);
 
-		for (uint32_t i = 0; i < x.rows(); i+=3)
-		{
-			m_Vertices.push_back(glm::vec3(x(i,0), x(i + 1, 0), x(i + 2, 0)));
+			GP_TRACE("PCA with {0} components took {1} ms", m_Model->GetComponentCount(), timer.ElapsedMilliseconds());
 		}
 
+		m_Coeffs.resize(m_Model->GetComponentCount(), 0.0f);
+		m_Vertices.resize(m_Model->GetVertexCount());
+		m_Model->Synthesize(m_Coeffs.data(), m_Vertices.data());
+
 		// Construct mesh
 		m_EditorMesh = EditorMesh::Create("Test", m_Vertices, m_Indices);
 
@@ -87,9 +49,9 @@ namespace GP
 
 	}
 
-	Ref<PCADatabase> PCADatabase::Create(Ref<ModelDatabase> modelDB)
+	Ref<PCADatabase> PCADatabase::Create(Ref<ModelDatabase> modelDB, const PCASpecs& specs)
 	{
-		return std::make_shared<PCADatabase>(modelDB);
+		return std::make_shared<PCADatabase>(modelDB, specs);
 	}
 
 	Ref<EditorMesh> PCADatabase::GetEditorMesh()
@@ -99,24 +61,12 @@ namespace GP
 
 	void PCADatabase::CalculateNewVertices()
 	{
-		// Calculate new vertices
-		Eigen::MatrixXd x = m_Mean;
-
-		m_Vertices.clear();
-
-		for (uint32_t i = 0; i < m_Eigenvectors.size(); i++)
+		// Every vertex moves with a coefficient, the shape is written
+		// straight into the vertices of the mesh
+		m_EditorMesh->UpdateAllVertices([this](glm::vec3* vertices)
 		{
-			x += m_Eigenvectors[i] * m_Coeffs[i];
-		}
-
-
-		for (uint32_t i = 0; i < x.rows(); i += 3)
-		{
-			m_Vertices.push_back(glm::vec3(x(i,0), x(i + 1, 0), x(i + 2, 0)));
-		}
-
-
-		m_EditorMesh->UpdateVertices(m_Vertices);
+			m_Model->Synthesize(m_Coeffs.data(), vertices);
+		});
 	}
 
 	float* PCADatabase::GetCoeff(uint32_t index)
@@ -129,68 +79,18 @@ namespace GP
 		return m_Coeffs.size();
 	}
 
-	Eigen::MatrixXd PCADatabase::CalculateMeanVertices()
+	void PCADatabase::AddShapes(const std::vector<MeshBlueprint>& meshes)
 	{
-		m_VertexSize = m_ModelDatabase->GetVertexCount();
-
-		// Declare a column matrix for the mean
-		Eigen::MatrixXd m = Eigen::MatrixXd::Zero(m_VertexSize * 3, 1);
-
-		m_MeanVertices.resize(m_VertexSize, glm::vec3(0.0f));
-		
-		uint32_t sampleCount = m_ModelDatabase->GetMeshCount();
-
-		std::vector<MeshBlueprint> meshes = m_ModelDatabase->GetMeshes();
-
-		
-
-		for (uint32_t i = 0; i < sampleCount; i++)
-		{
-
-			for (uint32_t j = 0; j < m_VertexSize; j++)
-			{
-
-				m(j*3, 0)     += meshes[i].vertices[j].x;
-				m(j*3 + 1, 0) += meshes[i].vertices[j].y;
-				m(j*3 + 2, 0) += meshes[i].vertices[j].z;
-				m_MeanVertices[j] += meshes[i].vertices[j];
-			}
-		}
-
-		for (uint32_t i = 0; i < sampleCount; i++)
-		{
-			m_MeanVertices[i] /= sampleCount;
-		}
-
-		m = m / sampleCount;
-
-		GP_TRACE("Mean Vertex Calculation has finished");
-
-		return m;
+		m_Model->AddShapes(meshes.data(), (uint32_t)meshes.size(), m_Specs);
+		m_Model->Save(GetModelPath());
 
+		m_Coeffs.assign(m_Model->GetComponentCount(), 0.0f);
+		CalculateNewVertices();
 	}
 
-	Eigen::MatrixXd PCADatabase::ConstructYMatrix(Eigen::MatrixXd mean)
+	std::filesystem::path PCADatabase::GetModelPath()
 	{
-		uint32_t sampleCount = m_ModelDatabase->GetMeshCount();
-
-		Eigen::MatrixXd yMatrix(m_VertexSize * 3, sampleCount);
-
-		std::vector<MeshBlueprint> meshes = m_ModelDatabase->GetMeshes();
-
-		for (uint32_t i = 0; i < sampleCount; i++)
-		{
-			for (uint32_t j = 0; j < m_VertexSize; j++)
-			{
-				yMatrix(j * 3, i)     = meshes[i].vertices[j].x;
-				yMatrix(j * 3 + 1, i) = meshes[i].vertices[j].y;
-				yMatrix(j * 3 + 2, i) = meshes[i].vertices[j].z;
-			}
-
-			yMatrix.col(i) -= mean;
-		}
-
-		return yMatrix;
+		return ResourceManager::GetOutputDirectory() / std::string("PCA_for_" + m_ModelDatabase->GetName() + ".pcam");
 	}
 
 	void PCADatabase::SetEditorMesh()
@@ -4,19 +4,19 @@
 #include <MeshOperations/EditorMesh.h>
 
 #include <vector>
+#include <filesystem>
 
-#include <Eigen/Core>
-#include <Spectra/SymEigsSolver.h>
+#include <MeshOperations/PCAModel.h>
 
 namespace GP
 {
 	class PCADatabase
 	{
 	public:
-		PCADatabase(Ref<ModelDatabase> modelDB);
+		PCADatabase(Ref<ModelDatabase> modelDB, const PCASpecs& specs = PCASpecs());
 		~PCADatabase();
 
-		static Ref<PCADatabase> Create(Ref<ModelDatabase> modelDB);
+		static Ref<PCADatabase> Create(Ref<ModelDatabase> modelDB, const PCASpecs& specs = PCASpecs());
 
 		Ref<EditorMesh> GetEditorMesh();
 
@@ -25,15 +25,20 @@ namespace GP
 		float* GetCoeff(uint32_t index);
 
 		uint32_t GetCoeffSize();
-	private:
 
-		Eigen::MatrixXd CalculateMeanVertices();
-		Eigen::MatrixXd ConstructYMatrix(Eigen::MatrixXd mean);
+		// Streams new shapes into the model without revisiting the old
+		// ones. The basis changes, so the coefficients are reset
+		void AddShapes(const std::vector<MeshBlueprint>& meshes);
+
+		const Ref<PCAModel>& GetModel() const { return m_Model; }
 
+		// Saved model of the database, loaded instead of recomputed when
+		// it was built from the same shapes and specs
+		std::filesystem::path GetModelPath();
+	private:
 
 		void SetEditorMesh();
 
-		std::vector<glm::vec3> m_MeanVertices;
 		std::vector<glm::vec3> m_Vertices;
 
 		std::vector<uint32_t> m_Indices;
@@ -41,10 +46,8 @@ namespace GP
 		Ref<ModelDatabase> m_ModelDatabase;
 		Ref<EditorMesh> m_EditorMesh;
 
-		uint32_t m_VertexSize;
-
-		Eigen::MatrixXd m_Mean;
-		std::vector<Eigen::MatrixXd> m_Eigenvectors;
+		PCASpecs m_Specs;
+		Ref<PCAModel> m_Model;
 		std::vector<float> m_Coeffs;
 
 	};
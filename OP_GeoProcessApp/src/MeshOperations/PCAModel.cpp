@@ -0,0 +1,347 @@
+#include <Precomp.h>
+#include <MeshOperations/PCAModel.h>
+
+#include <GeoProcess/System/Profiling/Timer.h>
+#include <GeoProcess/System/Utils/Hash.h>
+#include <GeoProcess/System/Utils/ParallelFor.h>
+
+namespace GP
+{
+	// Rows of the components below which synthesis stays on one thread
+	static const uint32_t MIN_ROWS_PER_THREAD = 1 << 16;
+
+	Ref<PCAModel> PCAModel::Create()
+	{
+		return std::make_shared<PCAModel>();
+	}
+
+	void PCAModel::AddShapes(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs)
+	{
+		if (count == 0)
+			return;
+
+		uint32_t vertexCount = IsEmpty() ? (uint32_t)meshes[0].vertices.size() : m_VertexCount;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (meshes[i].vertices.size() != vertexCount)
+			{
+				GP_ERROR("Shape {0} has {1} vertices, the model expects {2}", meshes[i].name, meshes[i].vertices.size(), vertexCount);
+				return;
+			}
+		}
+
+		Timer timer;
+
+		if (IsEmpty())
+		{
+			m_Specs = specs;
+			m_ShapeHashes.clear();
+			m_ContentHash = FNV_OFFSET;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint64_t hash = HashShape(meshes[i]);
+			m_ShapeHashes.push_back(hash);
+			AppendHash(m_ContentHash, &hash, sizeof(uint64_t));
+		}
+
+		uint32_t batchSize = specs.batchSize > 0 ? specs.batchSize : count;
+		uint32_t first = 0;
+
+		if (IsEmpty())
+		{
+			first = std::min(batchSize, count);
+
+			if (specs.precision == PCAPrecision::FLOAT32)
+				Initialize<float>(meshes, first, specs);
+			else
+				Initialize<double>(meshes, first, specs);
+		}
+
+		for (uint32_t begin = first; begin < count; begin += batchSize)
+			Update(meshes + begin, std::min(batchSize, count - begin), specs);
+
+		GP_TRACE("Added {0} shapes to the PCA model in {1} ms, {2} components explain {3} of the variance",
+			count, timer.ElapsedMilliseconds(), m_ComponentCount, GetExplainedVariance());
+	}
+
+	uint64_t PCAModel::HashShape(const MeshBlueprint& mesh)
+	{
+		uint64_t hash = FNV_OFFSET;
+		AppendHash(hash, mesh.vertices.data(), mesh.vertices.size() * sizeof(glm::vec3));
+		return hash;
+	}
+
+	template<typename Scalar>
+	void PCAModel::Initialize(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs)
+	{
+		typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+		uint32_t vertexCount = (uint32_t)meshes[0].vertices.size();
+		uint32_t rows = vertexCount * 3;
+
+		Eigen::VectorXd mean = Eigen::VectorXd::Zero(rows);
+		for (uint32_t i = 0; i < count; i++)
+			mean += Eigen::Map<const Eigen::VectorXf>(&meshes[i].vertices[0].x, rows).cast<double>();
+		mean /= (double)count;
+
+		// Centered samples as columns, 3V x M
+		Matrix y(rows, count);
+		for (uint32_t i = 0; i < count; i++)
+			y.col(i) = (Eigen::Map<const Eigen::VectorXf>(&meshes[i].vertices[0].x, rows).cast<double>() - mean).template cast<Scalar>();
+
+		RandomizedSVD<Scalar> svd;
+		svd.Compute(y, specs.svd);
+
+		m_VertexCount = vertexCount;
+		m_SampleCount = count;
+		m_TotalVariance = (double)y.squaredNorm();
+
+		Store(mean, svd.GetU().template cast<double>(), svd.GetSingularValues().template cast<double>());
+	}
+
+	void PCAModel::Update(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs)
+	{
+		uint32_t rows = m_VertexCount * 3;
+		uint32_t k = m_ComponentCount;
+
+		double n = (double)m_SampleCount;
+		double m = (double)count;
+
+		Eigen::MatrixXd u = Eigen::Map<const Eigen::MatrixXf>(m_Components, rows, k).cast<double>();
+		Eigen::VectorXd sigma = Eigen::Map<const Eigen::VectorXf>(m_SingularValues, k).cast<double>();
+		Eigen::VectorXd mean = Eigen::Map<const Eigen::VectorXf>(m_Mean, rows).cast<double>();
+
+		// The batch centered on its own mean, plus one column for the shift
+		// between the two means so the update is exact for the joint mean
+		Eigen::MatrixXd b(rows, count + 1);
+		for (uint32_t i = 0; i < count; i++)
+			b.col(i) = Eigen::Map<const Eigen::VectorXf>(&meshes[i].vertices[0].x, rows).cast<double>();
+
+		Eigen::VectorXd batchMean = b.leftCols(count).rowwise().mean();
+		b.leftCols(count).colwise() -= batchMean;
+		b.col(count) = std::sqrt(n * m / (n + m)) * (batchMean - mean);
+
+		m_TotalVariance += b.squaredNorm();
+
+		// Part of the batch inside the current basis and the residual
+		// outside of it. Projecting twice keeps the residual orthogonal to
+		// the float rounded components
+		Eigen::MatrixXd projection = u.transpose() * b;
+		Eigen::MatrixXd residual = b - u * projection;
+
+		Eigen::MatrixXd correction = u.transpose() * residual;
+		residual -= u * correction;
+		projection += correction;
+
+		Eigen::HouseholderQR<Eigen::MatrixXd> qr(residual);
+		Eigen::MatrixXd q = qr.householderQ() * Eigen::MatrixXd::Identity(rows, count + 1);
+
+		// Columns spanning a zero residual are arbitrary, they are only
+		// kept orthogonal to the basis
+		q -= u * (u.transpose() * q);
+		q = Eigen::HouseholderQR<Eigen::MatrixXd>(q).householderQ() * Eigen::MatrixXd::Identity(rows, count + 1);
+
+		// [U Q] K [V 0; 0 I]^T is the joint data matrix, only the small K
+		// is decomposed
+		uint32_t size = k + count + 1;
+		Eigen::MatrixXd middle = Eigen::MatrixXd::Zero(size, size);
+		middle.topLeftCorner(k, k) = sigma.asDiagonal();
+		middle.topRightCorner(k, count + 1) = projection;
+		middle.bottomRightCorner(count + 1, count + 1) = q.transpose() * residual;
+
+		Eigen::BDCSVD<Eigen::MatrixXd> svd(middle, Eigen::ComputeThinU);
+
+		Eigen::MatrixXd basis(rows, size);
+		basis.leftCols(k) = u;
+		basis.rightCols(count + 1) = q;
+
+		uint32_t rank = SelectRank(svd.singularValues(), specs.svd);
+		Eigen::MatrixXd components = basis * svd.matrixU().leftCols(rank);
+
+		m_SampleCount += count;
+		Store((n * mean + m * batchMean) / (n + m), components, svd.singularValues().head(rank));
+	}
+
+	uint32_t PCAModel::SelectRank(const Eigen::VectorXd& singularValues, const SVDSpecs& specs) const
+	{
+		uint32_t available = (uint32_t)singularValues.size();
+
+		if (specs.rank > 0)
+			return std::min(specs.rank, available);
+
+		double explained = 0.0;
+		uint32_t rank = 0;
+		while (rank < available && explained < specs.varianceThreshold * m_TotalVariance)
+		{
+			explained += singularValues(rank) * singularValues(rank);
+			rank++;
+		}
+
+		return std::max(rank, 1u);
+	}
+
+	void PCAModel::Store(const Eigen::VectorXd& mean, const Eigen::MatrixXd& components, const Eigen::VectorXd& singularValues)
+	{
+		m_ComponentCount = (uint32_t)components.cols();
+
+		m_MeanData.resize(mean.size());
+		m_SingularValueData.resize(singularValues.size());
+		m_ComponentData.resize(components.size());
+
+		Eigen::Map<Eigen::VectorXf>(m_MeanData.data(), mean.size()) = mean.cast<float>();
+		Eigen::Map<Eigen::VectorXf>(m_SingularValueData.data(), singularValues.size()) = singularValues.cast<float>();
+		Eigen::Map<Eigen::MatrixXf>(m_ComponentData.data(), components.rows(), components.cols()) = components.cast<float>();
+
+		m_Mean = m_MeanData.data();
+		m_SingularValues = m_SingularValueData.data();
+		m_Components = m_ComponentData.data();
+
+		// Nothing points into the mapping anymore
+		m_File.reset();
+	}
+
+	bool PCAModel::Save(const std::filesystem::path& path) const
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			GP_ERROR("Could not open {0} for writing", path.string());
+			return false;
+		}
+
+		PCAModelHeader header;
+		header.vertexCount = m_VertexCount;
+		header.componentCount = m_ComponentCount;
+		header.sampleCount = m_SampleCount;
+		header.totalVariance = m_TotalVariance;
+
+		header.precision = (uint32_t)m_Specs.precision;
+		header.batchSize = m_Specs.batchSize;
+		header.rank = m_Specs.svd.rank;
+		header.varianceThreshold = m_Specs.svd.varianceThreshold;
+		header.oversampling = m_Specs.svd.oversampling;
+		header.powerIterations = m_Specs.svd.powerIterations;
+		header.initialRank = m_Specs.svd.initialRank;
+		header.seed = m_Specs.svd.seed;
+		header.contentHash = m_ContentHash;
+
+		uint64_t rows = (uint64_t)m_VertexCount * 3;
+
+		file.write((const char*)&header, sizeof(PCAModelHeader));
+		file.write((const char*)m_Mean, rows * sizeof(float));
+		file.write((const char*)m_SingularValues, m_ComponentCount * sizeof(float));
+		file.write((const char*)m_Components, rows * m_ComponentCount * sizeof(float));
+		file.write((const char*)m_ShapeHashes.data(), m_ShapeHashes.size() * sizeof(uint64_t));
+
+		return file.good();
+	}
+
+	bool PCAModel::Load(const std::filesystem::path& path, const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs)
+	{
+		if (!std::filesystem::exists(path))
+			return false;
+
+		Ref<MappedFile> file = MappedFile::Create(path);
+		if (!file->IsOpen() || file->GetSize() < sizeof(PCAModelHeader))
+			return false;
+
+		PCAModelHeader header;
+		std::memcpy(&header, file->GetData(), sizeof(PCAModelHeader));
+
+		PCAModelHeader reference;
+		if (std::memcmp(header.magic, reference.magic, sizeof(reference.magic)) != 0 || header.version != reference.version)
+			return false;
+
+		if (header.precision != (uint32_t)specs.precision || header.batchSize != specs.batchSize ||
+			header.rank != specs.svd.rank || header.varianceThreshold != specs.svd.varianceThreshold ||
+			header.oversampling != specs.svd.oversampling || header.powerIterations != specs.svd.powerIterations ||
+			header.initialRank != specs.svd.initialRank || header.seed != specs.svd.seed)
+			return false;
+
+		if (count == 0 || header.vertexCount != meshes[0].vertices.size() || header.sampleCount < count)
+			return false;
+
+		uint64_t rows = (uint64_t)header.vertexCount * 3;
+		uint64_t k = header.componentCount;
+		uint64_t hashOffset = sizeof(PCAModelHeader) + (rows + k + rows * k) * sizeof(float);
+		if (file->GetSize() < hashOffset + header.sampleCount * sizeof(uint64_t))
+			return false;
+
+		std::vector<uint64_t> shapeHashes(header.sampleCount);
+		std::memcpy(shapeHashes.data(), file->GetData() + hashOffset, shapeHashes.size() * sizeof(uint64_t));
+
+		uint64_t contentHash = FNV_OFFSET;
+		AppendHash(contentHash, shapeHashes.data(), shapeHashes.size() * sizeof(uint64_t));
+		if (contentHash != header.contentHash)
+			return false;
+
+		// Hashing the shapes is the expensive check, it comes last. Shapes
+		// past count were added to the model later
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (meshes[i].vertices.size() != header.vertexCount || HashShape(meshes[i]) != shapeHashes[i])
+				return false;
+		}
+
+		m_VertexCount = header.vertexCount;
+		m_ComponentCount = header.componentCount;
+		m_SampleCount = header.sampleCount;
+		m_TotalVariance = header.totalVariance;
+
+		m_Specs = specs;
+		m_ShapeHashes = std::move(shapeHashes);
+		m_ContentHash = header.contentHash;
+
+		// The arrays are used in place, the header keeps them 4 byte aligned
+		const float* data = (const float*)(file->GetData() + sizeof(PCAModelHeader));
+		m_Mean = data;
+		m_SingularValues = data + rows;
+		m_Components = data + rows + k;
+
+		m_File = file;
+		m_MeanData.clear();
+		m_SingularValueData.clear();
+		m_ComponentData.clear();
+
+		return true;
+	}
+
+	float PCAModel::GetExplainedVariance() const
+	{
+		if (m_TotalVariance <= 0.0)
+			return 1.0f;
+
+		double explained = 0.0;
+		for (uint32_t i = 0; i < m_ComponentCount; i++)
+			explained += (double)m_SingularValues[i] * m_SingularValues[i];
+
+		return (float)(explained / m_TotalVariance);
+	}
+
+	void PCAModel::Synthesize(const float* coefficients, glm::vec3* outVertices) const
+	{
+		uint32_t rows = m_VertexCount * 3;
+
+		Eigen::Map<const Eigen::MatrixXf> components(m_Components, rows, m_ComponentCount);
+		Eigen::Map<const Eigen::VectorXf> mean(m_Mean, rows);
+
+		Eigen::VectorXf weights = Eigen::Map<const Eigen::VectorXf>(coefficients, m_ComponentCount).cwiseProduct(
+			Eigen::Map<const Eigen::VectorXf>(m_SingularValues, m_ComponentCount));
+
+		// glm::vec3 is three packed floats, the shape is one 3V vector
+		float* out = &outVertices[0].x;
+
+		// One GEMV per row block, the blocks are independent and each
+		// thread streams its own rows of the components once
+		auto synthesize = [&](uint32_t begin, uint32_t end)
+		{
+			Eigen::Map<Eigen::VectorXf> x(out + begin, end - begin);
+			x.noalias() = components.middleRows(begin, end - begin) * weights;
+			x += mean.segment(begin, end - begin);
+		};
+
+		ParallelFor(rows, synthesize, MIN_ROWS_PER_THREAD);
+	}
+}
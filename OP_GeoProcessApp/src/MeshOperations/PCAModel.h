@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+
+#include <glm/glm.hpp>
+
+#include <GeoProcess/System/Geometry/ModelDatabase.h>
+#include <GeoProcess/System/ResourceSystem/MappedFile.h>
+
+#include <MeshOperations/RandomizedSVD.h>
+
+namespace GP
+{
+	enum class PCAPrecision
+	{
+		FLOAT32 = 0,
+		FLOAT64 = 1
+	};
+
+	struct PCASpecs
+	{
+		// Precision of the first decomposition, float halves the memory
+		// of the data matrix. Updates always run in double
+		PCAPrecision precision = PCAPrecision::FLOAT64;
+
+		// Target rank or variance threshold of the components
+		SVDSpecs svd;
+
+		// Shapes streamed into the model per update, 0 decomposes the
+		// whole database at once
+		uint32_t batchSize = 0;
+	};
+
+	// Binary PCA model file (.pcam) layout: a fixed 80 byte header, then
+	// the mean (3V), the singular values (k) and the unit components
+	// (3V x k, column major) as floats, then one uint64_t hash per shape
+	// in the order the shapes were added. contentHash covers that list,
+	// so a model of other shapes with the same counts is ignored and one
+	// extended by AddShapes still matches the shapes it started from.
+	struct PCAModelHeader
+	{
+		char magic[4] = { 'P', 'C', 'A', '1' };
+		uint32_t version = 2;
+		uint32_t vertexCount = 0;
+		uint32_t componentCount = 0;
+		uint64_t sampleCount = 0;
+		double totalVariance = 0.0;
+
+		// PCASpecs the model was built with
+		uint32_t precision = 0;
+		uint32_t batchSize = 0;
+		uint32_t rank = 0;
+		float varianceThreshold = 0.0f;
+		uint32_t oversampling = 0;
+		uint32_t powerIterations = 0;
+		uint32_t initialRank = 0;
+		uint32_t seed = 0;
+
+		uint64_t contentHash = 0;
+		uint64_t reserved = 0;
+	};
+
+	// Mean and truncated principal basis of a set of shapes with the same
+	// connectivity. Shapes can be streamed in: a batch is projected onto
+	// the current basis, its residual adds new directions and only the
+	// small (k + b) matrix of the update is decomposed (Ross et al. 2008),
+	// so earlier shapes are never touched again. A saved model is read
+	// through a memory mapping and copied only when it is updated.
+	class PCAModel
+	{
+	public:
+		PCAModel() {}
+
+		static Ref<PCAModel> Create();
+
+		// The first batch starts the model with a randomized SVD, later
+		// ones update it. The rank rule of specs.svd is applied after
+		// every update
+		void AddShapes(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs);
+
+		bool Save(const std::filesystem::path& path) const;
+
+		// Succeeds only if the file was built with the same specs and
+		// meshes are the first shapes that went into it
+		bool Load(const std::filesystem::path& path, const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs);
+
+		bool IsEmpty() const { return m_SampleCount == 0; }
+		bool IsMapped() const { return m_File != nullptr; }
+
+		uint32_t GetVertexCount() const { return m_VertexCount; }
+		uint32_t GetComponentCount() const { return m_ComponentCount; }
+		uint64_t GetSampleCount() const { return m_SampleCount; }
+
+		// Fraction of the total variance kept by the components
+		float GetExplainedVariance() const;
+
+		const float* GetMean() const { return m_Mean; }
+		const float* GetSingularValues() const { return m_SingularValues; }
+
+		// Unit length, 3V floats
+		const float* GetComponent(uint32_t index) const { return m_Components + (uint64_t)index * m_VertexCount * 3; }
+
+		// mean + sum_i coefficients[i] * sigma_i * u_i as a single GEMV
+		// over the contiguous components, split into row blocks
+		void Synthesize(const float* coefficients, glm::vec3* outVertices) const;
+
+	private:
+		static uint64_t HashShape(const MeshBlueprint& mesh);
+
+		template<typename Scalar>
+		void Initialize(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs);
+		void Update(const MeshBlueprint* meshes, uint32_t count, const PCASpecs& specs);
+
+		// Number of leading singular values kept by the rank rule
+		uint32_t SelectRank(const Eigen::VectorXd& singularValues, const SVDSpecs& specs) const;
+
+		void Store(const Eigen::VectorXd& mean, const Eigen::MatrixXd& components, const Eigen::VectorXd& singularValues);
+
+	private:
+		uint32_t m_VertexCount = 0;
+		uint32_t m_ComponentCount = 0;
+		uint64_t m_SampleCount = 0;
+
+		// Sum of squared distances of all shapes to the mean
+		double m_TotalVariance = 0.0;
+
+		// Specs of the first batch and the hashes of every added shape,
+		// m_ContentHash is the hash of m_ShapeHashes
+		PCASpecs m_Specs;
+		std::vector<uint64_t> m_ShapeHashes;
+		uint64_t m_ContentHash = 0;
+
+		// Either into m_File or into the owned vectors below
+		const float* m_Mean = nullptr;
+		const float* m_SingularValues = nullptr;
+		const float* m_Components = nullptr;
+
+		Ref<MappedFile> m_File;
+		std::vector<float> m_MeanData;
+		std::vector<float> m_SingularValueData;
+		std::vector<float> m_ComponentData;
+	};
+}
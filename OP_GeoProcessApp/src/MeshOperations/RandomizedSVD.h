@@ -0,0 +1,142 @@
+#pragma once
+
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+#include <Eigen/Core>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+
+namespace GP
+{
+	struct SVDSpecs
+	{
+		// Number of components, 0 picks the smallest rank whose components
+		// explain varianceThreshold of the squared Frobenius norm
+		uint32_t rank = 0;
+		float varianceThreshold = 0.9f;
+
+		// Extra sketch columns and subspace iterations, more of either
+		// gives more accurate trailing components
+		uint32_t oversampling = 10;
+		uint32_t powerIterations = 2;
+
+		// First sketch size when the rank is picked by variance, doubled
+		// until the threshold is reached
+		uint32_t initialRank = 32;
+
+		uint32_t seed = 0;
+	};
+
+	// Truncated SVD of a tall matrix with a randomized range finder (Halko,
+	// Martinsson and Tropp). A Gaussian sketch Y Omega is orthonormalized and
+	// refined with a few subspace iterations, then only the small projected
+	// matrix Q^T Y is decomposed exactly. Neither Y^T Y nor any m x m
+	// matrix is formed, so the cost is a handful of products with Y.
+	template<typename Scalar>
+	class RandomizedSVD
+	{
+	public:
+		typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+		typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+		RandomizedSVD() {}
+
+		void Compute(const Matrix& y, const SVDSpecs& specs)
+		{
+			uint32_t maxRank = (uint32_t)std::min(y.rows(), y.cols());
+			double totalVariance = (double)y.squaredNorm();
+
+			uint32_t rank = specs.rank > 0 ? std::min(specs.rank, maxRank) : std::min(specs.initialRank, maxRank);
+
+			while (true)
+			{
+				uint32_t sketchSize = std::min(rank + specs.oversampling, maxRank);
+				Decompose(y, sketchSize, specs);
+
+				if (specs.rank > 0)
+					break;
+
+				// Smallest prefix reaching the threshold, the sketch is
+				// doubled when even all of it falls short
+				double explained = 0.0;
+				uint32_t needed = 0;
+				while (needed < m_SingularValues.size() && explained < specs.varianceThreshold * totalVariance)
+				{
+					explained += (double)m_SingularValues(needed) * (double)m_SingularValues(needed);
+					needed++;
+				}
+
+				if (explained >= specs.varianceThreshold * totalVariance || sketchSize == maxRank)
+				{
+					rank = needed;
+					break;
+				}
+
+				rank *= 2;
+			}
+
+			rank = std::min(rank, (uint32_t)m_SingularValues.size());
+			m_U.conservativeResize(Eigen::NoChange, rank);
+			m_V.conservativeResize(Eigen::NoChange, rank);
+			m_SingularValues.conservativeResize(rank);
+
+			double explained = (double)m_SingularValues.squaredNorm();
+			m_ExplainedVariance = totalVariance > 0.0 ? (float)(explained / totalVariance) : 1.0f;
+		}
+
+		uint32_t GetRank() const { return (uint32_t)m_SingularValues.size(); }
+
+		// Columns of U and V are the left and right singular vectors,
+		// singular values are in decreasing order
+		const Matrix& GetU() const { return m_U; }
+		const Matrix& GetV() const { return m_V; }
+		const Vector& GetSingularValues() const { return m_SingularValues; }
+
+		// Fraction of the squared Frobenius norm of Y kept by the rank
+		float GetExplainedVariance() const { return m_ExplainedVariance; }
+
+	private:
+		static Matrix Orthonormalize(const Matrix& a)
+		{
+			Eigen::HouseholderQR<Matrix> qr(a);
+			return qr.householderQ() * Matrix::Identity(a.rows(), a.cols());
+		}
+
+		void Decompose(const Matrix& y, uint32_t sketchSize, const SVDSpecs& specs)
+		{
+			std::mt19937 generator(specs.seed);
+			std::normal_distribution<double> distribution(0.0, 1.0);
+
+			Matrix omega(y.cols(), sketchSize);
+			for (Eigen::Index j = 0; j < omega.cols(); j++)
+			{
+				for (Eigen::Index i = 0; i < omega.rows(); i++)
+					omega(i, j) = (Scalar)distribution(generator);
+			}
+
+			// Orthonormalizing between the products keeps small singular
+			// directions from being lost to rounding
+			Matrix q = Orthonormalize(y * omega);
+			for (uint32_t i = 0; i < specs.powerIterations; i++)
+			{
+				Matrix z = Orthonormalize(y.transpose() * q);
+				q = Orthonormalize(y * z);
+			}
+
+			Matrix b = q.transpose() * y;
+			Eigen::BDCSVD<Matrix> svd(b, Eigen::ComputeThinU | Eigen::ComputeThinV);
+
+			m_U = q * svd.matrixU();
+			m_V = svd.matrixV();
+			m_SingularValues = svd.singularValues();
+		}
+
+	private:
+		Matrix m_U;
+		Matrix m_V;
+		Vector m_SingularValues;
+		float m_ExplainedVariance = 0.0f;
+	};
+}
@@ -0,0 +1,214 @@
+#include <Precomp.h>
+#include <MeshOperations/SpectralBasis.h>
+
+#include <Eigen/Sparse>
+#include <Spectra/SymGEigsShiftSolver.h>
+#include <Spectra/MatOp/SymShiftInvert.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+
+#include <GeoProcess/System/Geometry/LaplacianBuilder.h>
+#include <GeoProcess/System/ResourceSystem/MappedFile.h>
+#include <GeoProcess/System/Profiling/Timer.h>
+#include <GeoProcess/System/Utils/Hash.h>
+
+namespace GP
+{
+	Ref<SpectralBasis> SpectralBasis::Create()
+	{
+		return std::make_shared<SpectralBasis>();
+	}
+
+	bool SpectralBasis::Compute(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices, uint32_t basisSize)
+	{
+		Timer timer;
+
+		uint32_t vertexCount = topology.GetVertexCount();
+		basisSize = std::min(basisSize, vertexCount - 1);
+
+		LaplacianBuilder builder(topology);
+		builder.SetPositions(vertices);
+
+		const LaplacianBuilder::SparseMatrix& laplacian = builder.GetLaplacian(LaplacianType::COTANGENT);
+		const LaplacianBuilder::SparseMatrix& mass = builder.GetMassMatrix(MassType::LUMPED);
+
+		typedef Spectra::SymShiftInvert<double, Eigen::Sparse, Eigen::Sparse> ShiftInvertOp;
+		typedef Spectra::SparseSymMatProd<double> MassOp;
+
+		ShiftInvertOp op(laplacian, mass);
+		MassOp massOp(mass);
+
+		// L is singular, the shift has to keep L - sigma M invertible
+		// while staying below the zero eigenvalue
+		const double sigma = -1e-8;
+		uint32_t ncv = std::min(vertexCount, std::max(2 * basisSize + 1, 20u));
+
+		Spectra::SymGEigsShiftSolver<ShiftInvertOp, MassOp, Spectra::GEigsMode::ShiftInvert>
+			eigs(op, massOp, basisSize, ncv, sigma);
+
+		eigs.init();
+		eigs.compute(Spectra::SortRule::LargestMagn, 1000, 1e-8);
+
+		if (eigs.info() != Spectra::CompInfo::Successful)
+		{
+			GP_ERROR("Laplace-Beltrami eigenproblem did not converge");
+			return false;
+		}
+
+		Eigen::VectorXd eigenvalues = eigs.eigenvalues();
+		Eigen::MatrixXd eigenvectors = eigs.eigenvectors();
+
+		// Smallest frequency first
+		std::vector<uint32_t> order(basisSize);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return eigenvalues(a) < eigenvalues(b); });
+
+		m_Eigenvalues.resize(basisSize);
+		m_Eigenvectors.resize(vertexCount, basisSize);
+		for (uint32_t i = 0; i < basisSize; i++)
+		{
+			m_Eigenvalues(i) = (float)eigenvalues(order[i]);
+			m_Eigenvectors.col(i) = eigenvectors.col(order[i]).cast<float>();
+		}
+
+		m_Mass = mass.diagonal().cast<float>();
+		m_MeshHash = HashMesh(topology, vertices);
+		m_FaceCount = topology.GetFaceCount();
+
+		m_ComputeTime = timer.ElapsedMilliseconds();
+		GP_TRACE("Computed {0} Laplace-Beltrami eigenfunctions in {1} ms", basisSize, m_ComputeTime);
+
+		return true;
+	}
+
+	uint64_t SpectralBasis::HashMesh(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices)
+	{
+		uint64_t hash = FNV_OFFSET;
+		AppendHash(hash, vertices.data(), vertices.size() * sizeof(glm::vec3));
+		AppendHash(hash, topology.GetIndices().data(), topology.GetIndices().size() * sizeof(uint32_t));
+
+		return hash;
+	}
+
+	bool SpectralBasis::Save(const std::filesystem::path& path) const
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			GP_ERROR("Could not open {0} for writing", path.string());
+			return false;
+		}
+
+		SpectralBasisHeader header;
+		header.vertexCount = GetVertexCount();
+		header.faceCount = m_FaceCount;
+		header.basisSize = GetBasisSize();
+		header.meshHash = m_MeshHash;
+
+		file.write((const char*)&header, sizeof(SpectralBasisHeader));
+		file.write((const char*)m_Eigenvalues.data(), m_Eigenvalues.size() * sizeof(float));
+		file.write((const char*)m_Mass.data(), m_Mass.size() * sizeof(float));
+		file.write((const char*)m_Eigenvectors.data(), m_Eigenvectors.size() * sizeof(float));
+
+		return file.good();
+	}
+
+	bool SpectralBasis::Load(const std::filesystem::path& path, const HalfEdgeMesh& topology,
+		                     const std::vector<glm::vec3>& vertices, uint32_t basisSize)
+	{
+		if (!std::filesystem::exists(path))
+			return false;
+
+		Ref<MappedFile> file = MappedFile::Create(path);
+		if (!file->IsOpen() || file->GetSize() < sizeof(SpectralBasisHeader))
+			return false;
+
+		SpectralBasisHeader header;
+		std::memcpy(&header, file->GetData(), sizeof(SpectralBasisHeader));
+
+		SpectralBasisHeader reference;
+		if (std::memcmp(header.magic, reference.magic, sizeof(reference.magic)) != 0 || header.version != reference.version)
+			return false;
+
+		basisSize = std::min(basisSize, topology.GetVertexCount() - 1);
+		if (header.vertexCount != topology.GetVertexCount() || header.faceCount != topology.GetFaceCount() ||
+			header.basisSize < basisSize)
+			return false;
+
+		uint64_t n = header.vertexCount;
+		uint64_t k = header.basisSize;
+		if (file->GetSize() < sizeof(SpectralBasisHeader) + (k + n + n * k) * sizeof(float))
+			return false;
+
+		// Hashing is the expensive check, it comes last
+		if (header.meshHash != HashMesh(topology, vertices))
+			return false;
+
+		const float* data = (const float*)(file->GetData() + sizeof(SpectralBasisHeader));
+
+		// Only the requested prefix of the stored basis is kept
+		m_Eigenvalues = Eigen::Map<const Eigen::VectorXf>(data, basisSize);
+		m_Mass = Eigen::Map<const Eigen::VectorXf>(data + k, n);
+		m_Eigenvectors = Eigen::Map<const Eigen::MatrixXf>(data + k + n, n, k).leftCols(basisSize);
+
+		m_MeshHash = header.meshHash;
+		m_FaceCount = header.faceCount;
+
+		return true;
+	}
+
+	void SpectralBasis::Filter(const float* in, float* out, uint32_t bandCount) const
+	{
+		uint32_t n = GetVertexCount();
+		bandCount = std::min(bandCount, GetBasisSize());
+
+		Eigen::Map<const Eigen::VectorXf> signal(in, n);
+		Eigen::VectorXf coefficients = m_Eigenvectors.leftCols(bandCount).transpose() * m_Mass.cwiseProduct(signal);
+
+		Eigen::Map<Eigen::VectorXf>(out, n) = m_Eigenvectors.leftCols(bandCount) * coefficients;
+	}
+
+	void SpectralBasis::Filter(std::vector<glm::vec3>& positions, uint32_t bandCount) const
+	{
+		uint32_t n = GetVertexCount();
+		bandCount = std::min(bandCount, GetBasisSize());
+
+		// glm::vec3 is three packed floats, x, y and z are its columns
+		Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>> coordinates(&positions[0].x, n, 3);
+
+		Eigen::MatrixXf coefficients = m_Eigenvectors.leftCols(bandCount).transpose() * (m_Mass.asDiagonal() * coordinates);
+		coordinates = m_Eigenvectors.leftCols(bandCount) * coefficients;
+	}
+
+	std::vector<float> SpectralBasis::ComputeHeatKernelSignature(float t) const
+	{
+		Eigen::VectorXf weights = (-t * m_Eigenvalues.array()).exp().matrix();
+
+		std::vector<float> signature(GetVertexCount());
+		Eigen::Map<Eigen::VectorXf>(signature.data(), signature.size()) = m_Eigenvectors.cwiseAbs2() * weights;
+
+		return signature;
+	}
+
+	void SpectralBasis::ComputeDistances(uint32_t source, SpectralDistance type, float t, float* outDistances) const
+	{
+		// The constant eigenfunction is the same at every vertex and the
+		// first eigenvalue is zero, both distances start from the second
+		Eigen::VectorXf weights = Eigen::VectorXf::Zero(GetBasisSize());
+		for (uint32_t i = 1; i < GetBasisSize(); i++)
+		{
+			float lambda = m_Eigenvalues(i);
+
+			if (type == SpectralDistance::DIFFUSION)
+				weights(i) = std::exp(-2.0f * lambda * t);
+			else
+				weights(i) = lambda > 0.0f ? 1.0f / (lambda * lambda) : 0.0f;
+		}
+
+		Eigen::RowVectorXf sourceRow = m_Eigenvectors.row(source);
+
+		// Weighted squared differences to every vertex as one matrix vector
+		// product over the whole basis
+		Eigen::Map<Eigen::VectorXf> distances(outDistances, GetVertexCount());
+		distances = ((m_Eigenvectors.rowwise() - sourceRow).array().square().matrix() * weights).cwiseSqrt();
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+
+#include <glm/glm.hpp>
+
+#include <Eigen/Core>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+
+namespace GP
+{
+	enum class SpectralDistance
+	{
+		// Distance between heat kernels after time t
+		DIFFUSION = 0,
+		// Eigenfunctions weighted by 1 / lambda^2, smooth and parameter free
+		BIHARMONIC = 1
+	};
+
+	// Laplace-Beltrami basis file (.lbb) layout: a fixed 48 byte header,
+	// the eigenvalues, the lumped vertex masses and the eigenvectors one
+	// after another as column major floats. meshHash covers the
+	// positions and the indices so a cache of a modified mesh is ignored.
+	struct SpectralBasisHeader
+	{
+		char magic[4] = { 'L', 'B', 'B', '1' };
+		uint32_t version = 1;
+		uint32_t vertexCount = 0;
+		uint32_t faceCount = 0;
+		uint32_t basisSize = 0;
+		uint32_t reserved[3] = { 0, 0, 0 };
+		uint64_t meshHash = 0;
+		uint64_t reserved2 = 0;
+	};
+
+	// First k eigenpairs of the generalized problem L phi = lambda M phi
+	// with the cotangent Laplacian and the lumped mass. Spectra iterates
+	// with a shift-invert operator just below zero, so the smallest
+	// eigenvalues converge first and every iteration is one sparse solve.
+	// Eigenvectors are M-orthonormal, signals are projected with Phi^T M.
+	class SpectralBasis
+	{
+	public:
+		SpectralBasis() {}
+
+		static Ref<SpectralBasis> Create();
+
+		// Returns false if the solver did not converge
+		bool Compute(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices, uint32_t basisSize);
+
+		bool Save(const std::filesystem::path& path) const;
+
+		// Succeeds only if the file was written for this exact mesh and
+		// holds at least basisSize functions
+		bool Load(const std::filesystem::path& path, const HalfEdgeMesh& topology,
+			      const std::vector<glm::vec3>& vertices, uint32_t basisSize);
+
+		uint32_t GetVertexCount() const { return (uint32_t)m_Eigenvectors.rows(); }
+		uint32_t GetBasisSize() const { return (uint32_t)m_Eigenvectors.cols(); }
+
+		const Eigen::VectorXf& GetEigenvalues() const { return m_Eigenvalues; }
+		const Eigen::MatrixXf& GetEigenvectors() const { return m_Eigenvectors; }
+
+		// Keeps the first bandCount frequencies of a per vertex signal,
+		// in and out may be the same array
+		void Filter(const float* in, float* out, uint32_t bandCount) const;
+		void Filter(std::vector<glm::vec3>& positions, uint32_t bandCount) const;
+
+		// sum_i exp(-lambda_i t) phi_i(x)^2 for every vertex
+		std::vector<float> ComputeHeatKernelSignature(float t) const;
+
+		// Distances from source to every vertex, t is only used by DIFFUSION
+		void ComputeDistances(uint32_t source, SpectralDistance type, float t, float* outDistances) const;
+
+		float GetComputeTime() const { return m_ComputeTime; }
+
+	private:
+		static uint64_t HashMesh(const HalfEdgeMesh& topology, const std::vector<glm::vec3>& vertices);
+
+	private:
+		Eigen::VectorXf m_Eigenvalues;
+		Eigen::MatrixXf m_Eigenvectors;
+		Eigen::VectorXf m_Mass;
+
+		uint64_t m_MeshHash = 0;
+		uint32_t m_FaceCount = 0;
+		float m_ComputeTime = 0.0f;
+	};
+}
@@ -0,0 +1,111 @@
+#include <Precomp.h>
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+
+namespace GP
+{
+	HalfEdgeMesh::HalfEdgeMesh(uint32_t vertexCount, const std::vector<uint32_t>& indices)
+	{
+		Build(vertexCount, indices);
+	}
+
+	Ref<HalfEdgeMesh> HalfEdgeMesh::Create(uint32_t vertexCount, const std::vector<uint32_t>& indices)
+	{
+		return std::make_shared<HalfEdgeMesh>(vertexCount, indices);
+	}
+
+	void HalfEdgeMesh::Build(uint32_t vertexCount, const std::vector<uint32_t>& indices)
+	{
+		m_VertexCount = vertexCount;
+		m_Indices.assign(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+
+		uint32_t halfEdgeCount = (uint32_t)m_Indices.size();
+
+		// Pair opposite half-edges. Each half-edge gets the key of its
+		// undirected edge (smaller vertex first), sorting brings the two
+		// sides of an edge next to each other
+		struct EdgeKey
+		{
+			uint64_t key;
+			uint32_t halfEdge;
+
+			bool operator<(const EdgeKey& other) const
+			{
+				return key < other.key || (key == other.key && halfEdge < other.halfEdge);
+			}
+		};
+
+		std::vector<EdgeKey> keys(halfEdgeCount);
+		for (uint32_t h = 0; h < halfEdgeCount; h++)
+		{
+			uint64_t from = GetOrigin(h);
+			uint64_t to = GetTarget(h);
+
+			keys[h].key = from < to ? (from << 32) | to : (to << 32) | from;
+			keys[h].halfEdge = h;
+		}
+
+		std::sort(keys.begin(), keys.end());
+
+		m_Opposite.assign(halfEdgeCount, INVALID);
+
+		uint32_t i = 0;
+		while (i < halfEdgeCount)
+		{
+			uint32_t j = i + 1;
+			while (j < halfEdgeCount && keys[j].key == keys[i].key)
+				j++;
+
+			// Only manifold edges with consistent orientation are paired,
+			// anything else is treated as boundary on every side
+			if (j - i == 2)
+			{
+				uint32_t h1 = keys[i].halfEdge;
+				uint32_t h2 = keys[i + 1].halfEdge;
+
+				if (GetOrigin(h1) == GetTarget(h2))
+				{
+					m_Opposite[h1] = h2;
+					m_Opposite[h2] = h1;
+				}
+			}
+
+			i = j;
+		}
+
+		// Vertex to corner incidence with a counting sort
+		m_CornerOffsets.assign(vertexCount + 1, 0);
+		for (uint32_t h = 0; h < halfEdgeCount; h++)
+			m_CornerOffsets[m_Indices[h] + 1]++;
+
+		for (uint32_t v = 0; v < vertexCount; v++)
+			m_CornerOffsets[v + 1] += m_CornerOffsets[v];
+
+		m_Corners.resize(halfEdgeCount);
+		std::vector<uint32_t> fill(m_CornerOffsets.begin(), m_CornerOffsets.end() - 1);
+		for (uint32_t h = 0; h < halfEdgeCount; h++)
+			m_Corners[fill[m_Indices[h]]++] = h;
+
+		// Pick an outgoing half-edge for every vertex, a boundary one
+		// if the vertex has it
+		m_VertexHalfEdge.assign(vertexCount, INVALID);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			for (uint32_t c = m_CornerOffsets[v]; c < m_CornerOffsets[v + 1]; c++)
+			{
+				uint32_t h = m_Corners[c];
+
+				if (m_VertexHalfEdge[v] == INVALID || IsBoundary(h))
+					m_VertexHalfEdge[v] = h;
+
+				if (IsBoundary(h))
+					break;
+			}
+		}
+	}
+
+	bool HalfEdgeMesh::IsBoundaryVertex(uint32_t vertex) const
+	{
+		uint32_t h = m_VertexHalfEdge[vertex];
+		return h == INVALID || IsBoundary(h);
+	}
+}
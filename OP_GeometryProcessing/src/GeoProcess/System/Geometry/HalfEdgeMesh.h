@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#include <GeoProcess/System/CoreSystem/Core.h>
+
+namespace GP
+{
+	// Index based half-edge structure for triangle meshes (corner table
+	// layout). Half-edge h is the corner h of the index list: it lives in
+	// face h / 3, starts at m_Indices[h] and ends at the next corner of the
+	// same face, so next, previous, face and origin need no storage. Only
+	// the opposite half-edges, one outgoing half-edge per vertex and the
+	// vertex to corner incidence lists are kept.
+	class HalfEdgeMesh
+	{
+	public:
+		static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+		HalfEdgeMesh() {}
+		HalfEdgeMesh(uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+		static Ref<HalfEdgeMesh> Create(uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+		// O(F log F), the only sort is the one pairing opposite half-edges
+		void Build(uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+		uint32_t GetVertexCount()   const { return m_VertexCount; }
+		uint32_t GetFaceCount()     const { return (uint32_t)m_Indices.size() / 3; }
+		uint32_t GetHalfEdgeCount() const { return (uint32_t)m_Indices.size(); }
+
+		// ------------ Half-edge queries ------------ //
+		uint32_t GetFace(uint32_t halfEdge)     const { return halfEdge / 3; }
+		uint32_t GetNext(uint32_t halfEdge)     const { return (halfEdge % 3 == 2) ? halfEdge - 2 : halfEdge + 1; }
+		uint32_t GetPrev(uint32_t halfEdge)     const { return (halfEdge % 3 == 0) ? halfEdge + 2 : halfEdge - 1; }
+		uint32_t GetOrigin(uint32_t halfEdge)   const { return m_Indices[halfEdge]; }
+		uint32_t GetTarget(uint32_t halfEdge)   const { return m_Indices[GetNext(halfEdge)]; }
+		uint32_t GetOpposite(uint32_t halfEdge) const { return m_Opposite[halfEdge]; }
+		bool IsBoundary(uint32_t halfEdge)      const { return m_Opposite[halfEdge] == INVALID; }
+
+		// Next outgoing half-edge around the origin vertex, INVALID when
+		// the rotation hits a boundary
+		uint32_t GetNextOutgoing(uint32_t halfEdge) const { return m_Opposite[GetPrev(halfEdge)]; }
+
+		// --------------- Face queries --------------- //
+		uint32_t GetFaceHalfEdge(uint32_t face)              const { return face * 3; }
+		uint32_t GetFaceVertex(uint32_t face, uint32_t corner) const { return m_Indices[face * 3 + corner]; }
+
+		// -------------- Vertex queries -------------- //
+		// Outgoing half-edge of the vertex. For boundary vertices this is
+		// the boundary half-edge so rotating with GetNextOutgoing visits
+		// the whole one-ring
+		uint32_t GetVertexHalfEdge(uint32_t vertex) const { return m_VertexHalfEdge[vertex]; }
+		bool IsBoundaryVertex(uint32_t vertex) const;
+
+		// Corners (outgoing half-edges) incident to a vertex. These lists
+		// are also valid for non-manifold vertices where the rotation
+		// above cannot reach every face.
+		uint32_t GetCornerBegin(uint32_t vertex)  const { return m_CornerOffsets[vertex]; }
+		uint32_t GetCornerEnd(uint32_t vertex)    const { return m_CornerOffsets[vertex + 1]; }
+		uint32_t GetCorner(uint32_t i)            const { return m_Corners[i]; }
+		uint32_t GetValence(uint32_t vertex)      const { return m_CornerOffsets[vertex + 1] - m_CornerOffsets[vertex]; }
+
+		const std::vector<uint32_t>& GetIndices()  const { return m_Indices; }
+		const std::vector<uint32_t>& GetOpposites() const { return m_Opposite; }
+
+	private:
+		uint32_t m_VertexCount = 0;
+
+		std::vector<uint32_t> m_Indices;
+		std::vector<uint32_t> m_Opposite;
+		std::vector<uint32_t> m_VertexHalfEdge;
+
+		std::vector<uint32_t> m_CornerOffsets;
+		std::vector<uint32_t> m_Corners;
+	};
+}
@@ -0,0 +1,195 @@
+#include <Precomp.h>
+#include <GeoProcess/System/Geometry/LaplacianBuilder.h>
+
+#include <GeoProcess/System/Utils/ParallelFor.h>
+
+namespace GP
+{
+	LaplacianBuilder::LaplacianBuilder(const HalfEdgeMesh& topology)
+		: m_Topology(topology)
+	{
+		BuildPattern();
+	}
+
+	Ref<LaplacianBuilder> LaplacianBuilder::Create(const HalfEdgeMesh& topology)
+	{
+		return std::make_shared<LaplacianBuilder>(topology);
+	}
+
+	void LaplacianBuilder::BuildPattern()
+	{
+		uint32_t vertexCount = m_Topology.GetVertexCount();
+		uint32_t halfEdgeCount = m_Topology.GetHalfEdgeCount();
+
+		// Each chunk of half-edges fills its own triplet buffer, both
+		// directions of an edge are added so boundary edges are not missed
+		uint32_t chunkCount = GetParallelChunkCount(halfEdgeCount);
+		uint32_t chunkSize = (halfEdgeCount + chunkCount - 1) / std::max(1u, chunkCount);
+
+		std::vector<std::vector<Eigen::Triplet<double>>> buffers(chunkCount);
+		ParallelFor(chunkCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t chunk = begin; chunk < end; chunk++)
+			{
+				uint32_t first = chunk * chunkSize;
+				uint32_t last = std::min(halfEdgeCount, first + chunkSize);
+
+				std::vector<Eigen::Triplet<double>>& triplets = buffers[chunk];
+				triplets.reserve((last - first) * 2);
+
+				for (uint32_t h = first; h < last; h++)
+				{
+					uint32_t origin = m_Topology.GetOrigin(h);
+					uint32_t target = m_Topology.GetTarget(h);
+					triplets.emplace_back(origin, target, 1.0);
+					triplets.emplace_back(target, origin, 1.0);
+				}
+			}
+		});
+
+		std::vector<Eigen::Triplet<double>> triplets;
+		triplets.reserve(halfEdgeCount * 2 + vertexCount);
+		for (const auto& buffer : buffers)
+			triplets.insert(triplets.end(), buffer.begin(), buffer.end());
+
+		// Isolated vertices still get a diagonal entry
+		for (uint32_t v = 0; v < vertexCount; v++)
+			triplets.emplace_back(v, v, 1.0);
+
+		m_UniformLaplacian.resize(vertexCount, vertexCount);
+		m_UniformLaplacian.setFromTriplets(triplets.begin(), triplets.end());
+		m_UniformLaplacian.makeCompressed();
+
+		const int* outer = m_UniformLaplacian.outerIndexPtr();
+		const int* inner = m_UniformLaplacian.innerIndexPtr();
+
+		auto findSlot = [&](uint32_t row, uint32_t column)
+		{
+			const int* begin = inner + outer[column];
+			const int* end = inner + outer[column + 1];
+			return (uint32_t)(std::lower_bound(begin, end, (int)row) - inner);
+		};
+
+		// Every half-edge is in exactly one corner list
+		m_OutgoingSlots.resize(halfEdgeCount);
+		m_IncomingSlots.resize(halfEdgeCount);
+		m_DiagonalSlots.resize(vertexCount);
+
+		// Uniform weights are 1 for every neighbor, each vertex only
+		// touches its own column
+		double* values = m_UniformLaplacian.valuePtr();
+		ParallelFor(vertexCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t v = begin; v < end; v++)
+			{
+				for (uint32_t c = m_Topology.GetCornerBegin(v); c < m_Topology.GetCornerEnd(v); c++)
+				{
+					uint32_t h = m_Topology.GetCorner(c);
+					m_OutgoingSlots[c] = findSlot(m_Topology.GetTarget(h), v);
+					m_IncomingSlots[c] = findSlot(m_Topology.GetOrigin(m_Topology.GetPrev(h)), v);
+				}
+
+				m_DiagonalSlots[v] = findSlot(v, v);
+
+				uint32_t diagonal = m_DiagonalSlots[v];
+				for (int i = outer[v]; i < outer[v + 1]; i++)
+					values[i] = (uint32_t)i == diagonal ? (double)(outer[v + 1] - outer[v] - 1) : -1.0;
+			}
+		});
+
+		m_CotangentLaplacian = m_UniformLaplacian;
+		m_ConsistentMass = m_UniformLaplacian;
+
+		// The lumped mass only has the diagonal, value v is entry (v, v)
+		m_LumpedMass.resize(vertexCount, vertexCount);
+		m_LumpedMass.setIdentity();
+	}
+
+	void LaplacianBuilder::SetPositions(const std::vector<glm::vec3>& vertices)
+	{
+		uint32_t vertexCount = m_Topology.GetVertexCount();
+		uint32_t faceCount = m_Topology.GetFaceCount();
+
+		m_HalfEdgeWeights.resize(faceCount * 3);
+		m_FaceAreas.resize(faceCount);
+
+		ParallelFor(faceCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t f = begin; f < end; f++)
+			{
+				glm::dvec3 p[3];
+				for (uint32_t i = 0; i < 3; i++)
+					p[i] = glm::dvec3(vertices[m_Topology.GetFaceVertex(f, i)]);
+
+				double doubleArea = glm::length(glm::cross(p[1] - p[0], p[2] - p[0]));
+				m_FaceAreas[f] = doubleArea * 0.5;
+
+				// Half-edge i goes from corner i to corner i + 1, the angle
+				// opposite to it is at corner i + 2. Degenerate faces add
+				// nothing instead of infinite weights
+				for (uint32_t i = 0; i < 3; i++)
+				{
+					const glm::dvec3& apex = p[(i + 2) % 3];
+					double cosine = glm::dot(p[i] - apex, p[(i + 1) % 3] - apex);
+					m_HalfEdgeWeights[f * 3 + i] = doubleArea > 0.0 ? 0.5 * cosine / doubleArea : 0.0;
+				}
+			}
+		});
+
+		double edgeLengthSum = 0.0;
+		for (uint32_t h = 0; h < faceCount * 3; h++)
+			edgeLengthSum += glm::length(vertices[m_Topology.GetTarget(h)] - vertices[m_Topology.GetOrigin(h)]);
+
+		m_MeanEdgeLength = faceCount > 0 ? edgeLengthSum / (faceCount * 3.0) : 0.0;
+
+		double* cotangent = m_CotangentLaplacian.valuePtr();
+		double* lumped = m_LumpedMass.valuePtr();
+		double* consistent = m_ConsistentMass.valuePtr();
+		const int* outer = m_UniformLaplacian.outerIndexPtr();
+
+		// An edge (v, u) gets the weight of both half-edges between v and
+		// u, one of them is an outgoing corner of v and the other the
+		// incoming half-edge of another corner of v
+		ParallelFor(vertexCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t v = begin; v < end; v++)
+			{
+				for (int i = outer[v]; i < outer[v + 1]; i++)
+				{
+					cotangent[i] = 0.0;
+					consistent[i] = 0.0;
+				}
+
+				uint32_t diagonal = m_DiagonalSlots[v];
+				lumped[v] = 0.0;
+
+				for (uint32_t c = m_Topology.GetCornerBegin(v); c < m_Topology.GetCornerEnd(v); c++)
+				{
+					uint32_t outgoing = m_Topology.GetCorner(c);
+					uint32_t incoming = m_Topology.GetPrev(outgoing);
+					double area = m_FaceAreas[m_Topology.GetFace(outgoing)];
+
+					cotangent[m_OutgoingSlots[c]] -= m_HalfEdgeWeights[outgoing];
+					cotangent[m_IncomingSlots[c]] -= m_HalfEdgeWeights[incoming];
+					cotangent[diagonal] += m_HalfEdgeWeights[outgoing] + m_HalfEdgeWeights[incoming];
+
+					lumped[v] += area / 3.0;
+
+					consistent[m_OutgoingSlots[c]] += area / 12.0;
+					consistent[m_IncomingSlots[c]] += area / 12.0;
+					consistent[diagonal] += area / 6.0;
+				}
+			}
+		});
+	}
+
+	const LaplacianBuilder::SparseMatrix& LaplacianBuilder::GetLaplacian(LaplacianType type) const
+	{
+		return type == LaplacianType::UNIFORM ? m_UniformLaplacian : m_CotangentLaplacian;
+	}
+
+	const LaplacianBuilder::SparseMatrix& LaplacianBuilder::GetMassMatrix(MassType type) const
+	{
+		return type == MassType::LUMPED ? m_LumpedMass : m_ConsistentMass;
+	}
+}
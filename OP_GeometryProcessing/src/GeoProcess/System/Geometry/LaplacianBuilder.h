@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
+
+namespace GP
+{
+	enum class LaplacianType
+	{
+		UNIFORM = 0,
+		COTANGENT = 1
+	};
+
+	enum class MassType
+	{
+		// Diagonal, a third of every adjacent face area (barycentric)
+		LUMPED = 0,
+		// Linear finite element mass, A/6 on the diagonal and A/12 for
+		// every edge of a face
+		CONSISTENT = 1
+	};
+
+	// Sparse Laplacians and mass matrices of a triangle mesh. Laplacians are
+	// positive semi-definite (L = D - W) and every operator shares one
+	// sparsity pattern: the vertex adjacency plus the diagonal. The pattern
+	// is assembled once from per-thread triplet buffers, afterwards each
+	// vertex writes its own column through precomputed value slots, so
+	// moving vertices only recomputes values.
+	class LaplacianBuilder
+	{
+	public:
+		typedef Eigen::SparseMatrix<double> SparseMatrix;
+
+		// The topology has to outlive the builder
+		LaplacianBuilder(const HalfEdgeMesh& topology);
+
+		static Ref<LaplacianBuilder> Create(const HalfEdgeMesh& topology);
+
+		// Recomputes the cotangent Laplacian and the mass matrices for new
+		// positions, the uniform Laplacian only depends on the topology
+		void SetPositions(const std::vector<glm::vec3>& vertices);
+
+		const SparseMatrix& GetLaplacian(LaplacianType type) const;
+		const SparseMatrix& GetMassMatrix(MassType type) const;
+
+		// Both are from the last SetPositions call
+		const std::vector<double>& GetFaceAreas() const { return m_FaceAreas; }
+		double GetMeanEdgeLength() const { return m_MeanEdgeLength; }
+
+	private:
+		void BuildPattern();
+
+	private:
+		const HalfEdgeMesh& m_Topology;
+
+		SparseMatrix m_UniformLaplacian;
+		SparseMatrix m_CotangentLaplacian;
+		SparseMatrix m_LumpedMass;
+		SparseMatrix m_ConsistentMass;
+
+		// Value slots in column v for the corner list entry c of v:
+		// (target, v) of the outgoing half-edge, (origin, v) of the
+		// incoming one, and (v, v)
+		std::vector<uint32_t> m_OutgoingSlots;
+		std::vector<uint32_t> m_IncomingSlots;
+		std::vector<uint32_t> m_DiagonalSlots;
+
+		// Half the cotangent of the angle opposite to each half-edge
+		std::vector<double> m_HalfEdgeWeights;
+		std::vector<double> m_FaceAreas;
+		double m_MeanEdgeLength = 0.0;
+	};
+}
@@ -200,11 +200,17 @@ namespace GP
 
 	void Mesh::SetupMesh()
 	{
-		// clear buffers if they are already allocated
+		// Meshes that are set up again (e.g. after their vertices move)
+		// rewrite the existing buffers, the vertex array keeps its bindings
+		if (m_VertexArray)
+		{
+			m_VertexBuffer->SetData(&m_ArrayBuffer[0], m_ArrayBuffer.size() * sizeof(Vertex));
 
-		//if (m_VertexArray.get())
-			//delete m_VertexArray.get();
+			if (m_IndexBuffer->GetCount() != m_Indices.size())
+				m_IndexBuffer->SetData(&m_Indices[0], m_Indices.size());
 
+			return;
+		}
 
 		m_VertexArray = VertexArray::Create();
 
@@ -222,7 +228,12 @@ namespace GP
 		);
 
 		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
-		m_IndexBuffer = IndexBuffer::Create(&m_Indices[0], m_Indices.size());
+
+		// A derived mesh may have created the index buffer already to
+		// share it with its other vertex arrays
+		if (!m_IndexBuffer)
+			m_IndexBuffer = IndexBuffer::Create(&m_Indices[0], m_Indices.size());
+
 		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
 	}
 
@@ -302,6 +313,20 @@ namespace GP
 		m_Bitangents.clear();
 		m_TexCoords.clear();
 		m_Indices.clear();
+		m_HalfEdgeMesh.reset();
+	}
+
+	void Mesh::SetupHalfEdgeMesh()
+	{
+		m_HalfEdgeMesh = HalfEdgeMesh::Create((uint32_t)m_Vertices.size(), m_Indices);
+	}
+
+	const Ref<HalfEdgeMesh>& Mesh::GetHalfEdgeMesh()
+	{
+		if (!m_HalfEdgeMesh)
+			SetupHalfEdgeMesh();
+
+		return m_HalfEdgeMesh;
 	}
 
 	uint32_t Mesh::GetVertexCount()   const { return (unsigned int)m_Vertices.size() / 3; }
@@ -3,6 +3,7 @@
 #define MAX_BONE_INFLUENCE 4
 
 #include <GeoProcess/System/RenderSystem/VertexArray.h>
+#include <GeoProcess/System/Geometry/HalfEdgeMesh.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -61,6 +62,12 @@ namespace GP
 
 		void ClearArrays();
 
+		// Half-edge topology of the index list. It is built on first
+		// use so meshes that never need neighborhood queries don't pay
+		// for it
+		void SetupHalfEdgeMesh();
+		const Ref<HalfEdgeMesh>& GetHalfEdgeMesh();
+
 		uint32_t GetVertexCount()    const;
 		uint32_t GetNormalCount()    const;
 		uint32_t GetBitangentCount() const;
@@ -120,6 +127,7 @@ namespace GP
 		Ref<VertexBuffer> m_VertexBuffer;
 		Ref<IndexBuffer> m_IndexBuffer;
 
+		Ref<HalfEdgeMesh> m_HalfEdgeMesh;
 
 		bool m_Smooth;
 	};
@@ -45,6 +45,7 @@ namespace GP
 		ModelMesh ProcessMesh(aiMesh* mesh, const aiScene* scene, aiNode* currentNode, std::unordered_map<std::string, BoneInfo>& boneInfoMap, int& BoneCounter);
 
 		ModelMesh GetMesh(uint32_t index);
+		uint32_t GetMeshCount() const { return (uint32_t)m_ModelMeshes.size(); }
 
 		static Ref<Model> Create(aiNode* rootNode, const aiScene* scene);
 
@@ -0,0 +1,79 @@
+#include <Precomp.h>
+#include <GeoProcess/System/Geometry/VertexAdjacency.h>
+
+namespace GP
+{
+	VertexAdjacency::VertexAdjacency(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Build(vertices, indices);
+	}
+
+	Ref<VertexAdjacency> VertexAdjacency::Create(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+	{
+		return std::make_shared<VertexAdjacency>(vertices, indices);
+	}
+
+	void VertexAdjacency::Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Clear();
+
+		uint32_t vertexCount = (uint32_t)vertices.size();
+
+		// Every triangle contributes its three edges in both directions.
+		// A directed edge is packed as (from << 32 | to) so sorting the
+		// keys groups them by source vertex and orders the neighbors
+		std::vector<uint64_t> keys;
+		keys.reserve(indices.size() * 2);
+
+		for (uint32_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint64_t idx1 = indices[i];
+			uint64_t idx2 = indices[i + 1];
+			uint64_t idx3 = indices[i + 2];
+
+			keys.push_back((idx1 << 32) | idx2);
+			keys.push_back((idx1 << 32) | idx3);
+			keys.push_back((idx2 << 32) | idx1);
+			keys.push_back((idx2 << 32) | idx3);
+			keys.push_back((idx3 << 32) | idx1);
+			keys.push_back((idx3 << 32) | idx2);
+		}
+
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		m_Offsets.resize(vertexCount + 1, 0);
+		m_Neighbors.resize(keys.size());
+
+		// Count the degree of each vertex, then turn the
+		// counts into offsets with a prefix sum
+		for (uint32_t i = 0; i < keys.size(); i++)
+		{
+			m_Offsets[(uint32_t)(keys[i] >> 32) + 1]++;
+			m_Neighbors[i] = (uint32_t)(keys[i] & 0xffffffff);
+		}
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+			m_Offsets[i + 1] += m_Offsets[i];
+
+		UpdateEdgeLengths(vertices);
+	}
+
+	void VertexAdjacency::UpdateEdgeLengths(const std::vector<glm::vec3>& vertices)
+	{
+		m_EdgeLengths.resize(m_Neighbors.size());
+
+		for (uint32_t v = 0; v < GetVertexCount(); v++)
+		{
+			for (uint32_t e = m_Offsets[v]; e < m_Offsets[v + 1]; e++)
+				m_EdgeLengths[e] = glm::distance(vertices[v], vertices[m_Neighbors[e]]);
+		}
+	}
+
+	void VertexAdjacency::Clear()
+	{
+		m_Offsets.clear();
+		m_Neighbors.clear();
+		m_EdgeLengths.clear();
+	}
+}
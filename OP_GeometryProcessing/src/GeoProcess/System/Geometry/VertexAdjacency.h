@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <GeoProcess/System/CoreSystem/Core.h>
+
+namespace GP
+{
+	// Compressed sparse row (CSR) vertex adjacency. Neighbors of vertex v
+	// are stored in m_Neighbors[m_Offsets[v] .. m_Offsets[v + 1]) and the
+	// length of the edge to each neighbor is kept at the same position in
+	// m_EdgeLengths, so a traversal never touches a hash table and the
+	// whole structure is three flat allocations.
+	class VertexAdjacency
+	{
+	public:
+		VertexAdjacency() {}
+		VertexAdjacency(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+		static Ref<VertexAdjacency> Create(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+		// Builds the structure with a single sort over the directed
+		// edges of all triangles in the index list
+		void Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+		// Topology does not change when vertices move, only the
+		// lengths have to be refreshed
+		void UpdateEdgeLengths(const std::vector<glm::vec3>& vertices);
+
+		void Clear();
+
+		uint32_t GetVertexCount() const { return m_Offsets.empty() ? 0 : (uint32_t)m_Offsets.size() - 1; }
+		uint32_t GetEdgeCount()   const { return (uint32_t)m_Neighbors.size(); }
+
+		uint32_t GetDegree(uint32_t vertex) const { return m_Offsets[vertex + 1] - m_Offsets[vertex]; }
+		uint32_t Begin(uint32_t vertex)     const { return m_Offsets[vertex]; }
+		uint32_t End(uint32_t vertex)       const { return m_Offsets[vertex + 1]; }
+
+		uint32_t GetNeighbor(uint32_t edge)  const { return m_Neighbors[edge]; }
+		float GetEdgeLength(uint32_t edge)   const { return m_EdgeLengths[edge]; }
+
+		const std::vector<uint32_t>& GetOffsets()   const { return m_Offsets; }
+		const std::vector<uint32_t>& GetNeighbors() const { return m_Neighbors; }
+		const std::vector<float>& GetEdgeLengths()  const { return m_EdgeLengths; }
+
+	private:
+		std::vector<uint32_t> m_Offsets;
+		std::vector<uint32_t> m_Neighbors;
+		std::vector<float> m_EdgeLengths;
+	};
+}
@@ -33,6 +33,8 @@ namespace GP
 		{
 		case RendererAPI::API::OpenGL: return std::make_shared<OpenGLVertexBuffer>(size, true);
 		}
+
+		return nullptr;
 	}
 
 	Ref<IndexBuffer> IndexBuffer::Create(uint32_t* indices, uint32_t size)
@@ -126,7 +126,23 @@ namespace GP
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
+		// Rewrites the buffer in place, the buffer object and every vertex
+		// array using it stay the same. A full rewrite orphans the old
+		// storage so the driver does not wait for draws still reading it,
+		// and a larger size grows the storage
 		virtual void SetData(const void* data, uint32_t size) = 0;
+		virtual void SetSubData(const void* data, uint32_t size, uint32_t offset) = 0;
+
+		// Write only mapping of the whole buffer. The old contents are
+		// discarded, so everything the draws read has to be written
+		// before Unmap. Saves the staging copy of SetData for streams
+		// that are rebuilt every frame
+		virtual void* Map() = 0;
+		virtual void Unmap() = 0;
+
+		virtual uint32_t GetSize() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
 		virtual const BufferLayout& GetLayout() const = 0;
 		virtual void SetLayout(const BufferLayout& layout) = 0;
 
@@ -146,6 +162,10 @@ namespace GP
 
 		virtual uint32_t GetCount() const = 0;
 
+		// Same object with new contents, vertex arrays using the
+		// buffer do not have to be rebuilt
+		virtual void SetData(const uint32_t* indices, uint32_t count) = 0;
+
 		static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t count);
 	};
 }
\ No newline at end of file
@@ -5,21 +5,21 @@
 
 namespace GP
 {
-	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size) : m_Size(size), m_Usage(GL_STATIC_DRAW)
 	{
 		glCreateBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STATIC_DRAW);
 	}
 
-	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size, bool flag)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size, bool flag) : m_Size(size), m_Usage(GL_DYNAMIC_DRAW)
 	{
 		glCreateBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
-	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size) : m_Size(size), m_Usage(GL_STATIC_DRAW)
 	{
 		glCreateBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
@@ -32,8 +32,40 @@ namespace GP
 
 	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		// A buffer that is rewritten is not static anymore
+		m_Usage = GL_DYNAMIC_DRAW;
+
+		// Orphaning gives the buffer fresh storage while draws that are
+		// still in flight keep reading the old one
+		if (size >= m_Size)
+		{
+			m_Size = size;
+			glNamedBufferData(m_RendererID, m_Size, data, m_Usage);
+			return;
+		}
+
+		glNamedBufferData(m_RendererID, m_Size, nullptr, m_Usage);
+		glNamedBufferSubData(m_RendererID, 0, size, data);
+	}
+
+	void OpenGLVertexBuffer::SetSubData(const void* data, uint32_t size, uint32_t offset)
+	{
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	void* OpenGLVertexBuffer::Map()
+	{
+		m_Usage = GL_DYNAMIC_DRAW;
+
+		// Invalidating lets the driver hand out fresh storage instead of
+		// waiting for draws still reading the old contents
+		return glMapNamedBufferRange(m_RendererID, 0, m_Size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	}
+
+	void OpenGLVertexBuffer::Unmap()
+	{
+		if (glUnmapNamedBuffer(m_RendererID) == GL_FALSE)
+			GP_WARN("Contents of vertex buffer {0} were lost while it was mapped", m_RendererID);
 	}
 
 
@@ -46,6 +78,13 @@ namespace GP
 	}
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer() { glDeleteBuffers(1, &m_RendererID); }
+
+	void OpenGLIndexBuffer::SetData(const uint32_t* indices, uint32_t count)
+	{
+		m_Count = count;
+		glNamedBufferData(m_RendererID, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+	}
+
 	void OpenGLIndexBuffer::Bind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID); }
 	void OpenGLIndexBuffer::Unbind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
 }
\ No newline at end of file
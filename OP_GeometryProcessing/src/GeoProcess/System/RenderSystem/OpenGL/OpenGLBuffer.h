@@ -17,11 +17,19 @@ namespace GP
 		virtual void Unbind() const override;
 
 		virtual void SetData(const void* data, uint32_t size) override;
+		virtual void SetSubData(const void* data, uint32_t size, uint32_t offset) override;
+		virtual void* Map() override;
+		virtual void Unmap() override;
+		virtual uint32_t GetSize() const override { return m_Size; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
 
 	private:
 		uint32_t m_RendererID;
+		uint32_t m_Size = 0;
+		uint32_t m_Usage;
 		BufferLayout m_Layout;
 	};
 
@@ -35,6 +43,7 @@ namespace GP
 		virtual void Unbind() const override;
 
 		virtual uint32_t GetCount() const { return m_Count; }
+		virtual void SetData(const uint32_t* indices, uint32_t count) override;
 	private:
 		uint32_t m_RendererID;
 		uint32_t m_Count;
@@ -187,4 +187,45 @@ namespace GP
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 
+
+	OpenGLBufferTexture::OpenGLBufferTexture(uint32_t count) : m_Count(count)
+	{
+		glCreateBuffers(1, &m_BufferID);
+		glNamedBufferData(m_BufferID, std::max(1u, count) * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+		glCreateTextures(GL_TEXTURE_BUFFER, 1, &m_RendererID);
+		glTextureBuffer(m_RendererID, GL_R32F, m_BufferID);
+	}
+
+	OpenGLBufferTexture::~OpenGLBufferTexture()
+	{
+		glDeleteTextures(1, &m_RendererID);
+		glDeleteBuffers(1, &m_BufferID);
+	}
+
+	void OpenGLBufferTexture::SetData(void* data, uint32_t size)
+	{
+		uint32_t count = size / sizeof(float);
+
+		// New storage has to be attached to the texture again
+		if (count > m_Count)
+		{
+			m_Count = count;
+			glNamedBufferData(m_BufferID, size, data, GL_DYNAMIC_DRAW);
+			glTextureBuffer(m_RendererID, GL_R32F, m_BufferID);
+			return;
+		}
+
+		glNamedBufferSubData(m_BufferID, 0, size, data);
+	}
+
+	void OpenGLBufferTexture::Bind(uint32_t slot) const
+	{
+		glBindTextureUnit(slot, m_RendererID);
+	}
+
+	void OpenGLBufferTexture::Unbind() const
+	{
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
 }
\ No newline at end of file
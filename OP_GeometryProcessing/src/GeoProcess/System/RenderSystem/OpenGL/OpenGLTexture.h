@@ -37,4 +37,31 @@ namespace GP
 		uint32_t m_RendererID;
 		GLenum m_InternalFormat, m_DataFormat;
 	};
+
+	class OpenGLBufferTexture : public BufferTexture
+	{
+	public:
+		OpenGLBufferTexture(uint32_t count);
+		virtual ~OpenGLBufferTexture();
+
+		virtual uint32_t GetWidth() const override { return m_Count; }
+		virtual uint32_t GetHeight() const override { return 1; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
+		// size is in bytes, the buffer grows when it is too small
+		virtual void SetData(void* data, uint32_t size) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+		virtual void Unbind() const override;
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == ((OpenGLBufferTexture&)other).m_RendererID;
+		}
+
+	private:
+		uint32_t m_Count;
+		uint32_t m_RendererID;
+		uint32_t m_BufferID;
+	};
 }
\ No newline at end of file
@@ -32,11 +32,13 @@ namespace GP
 
 	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
-		vertexBuffer->Bind();
-
-		uint32_t index = 0;
+		uint32_t binding = (uint32_t)m_VertexBuffers.size();
 		const auto& layout = vertexBuffer->GetLayout();
+
+		glVertexArrayVertexBuffer(m_RendererID, binding, vertexBuffer->GetRendererID(), 0, layout.GetStride());
+
+		// Attribute indices continue from the previous buffers, starting
+		// each buffer at 0 would overwrite their attributes
 		for (const auto& element : layout)
 		{
 			switch (element.Type)
@@ -46,14 +48,14 @@ namespace GP
 				case ShaderDataType::Float3:
 				case ShaderDataType::Float4:
 				{
-					glEnableVertexAttribArray(index);
-					glVertexAttribPointer(index,
+					glEnableVertexArrayAttrib(m_RendererID, m_AttributeIndex);
+					glVertexArrayAttribFormat(m_RendererID, m_AttributeIndex,
 						element.GetComponentCount(),
 						ShaderDataTypeToOpenGLBaseType(element.Type),
 						element.Normalized ? GL_TRUE : GL_FALSE,
-						layout.GetStride(),
-						(const void*)element.Offset);
-					index++;
+						element.Offset);
+					glVertexArrayAttribBinding(m_RendererID, m_AttributeIndex, binding);
+					m_AttributeIndex++;
 					break;
 				}
 
@@ -63,13 +65,13 @@ namespace GP
 				case ShaderDataType::Int4:
 				case ShaderDataType::Bool:
 				{
-					glEnableVertexAttribArray(index);
-					glVertexAttribIPointer(index,
+					glEnableVertexArrayAttrib(m_RendererID, m_AttributeIndex);
+					glVertexArrayAttribIFormat(m_RendererID, m_AttributeIndex,
 						element.GetComponentCount(),
 						ShaderDataTypeToOpenGLBaseType(element.Type),
-						layout.GetStride(),
-						(const void*)element.Offset);
-					index++;
+						element.Offset);
+					glVertexArrayAttribBinding(m_RendererID, m_AttributeIndex, binding);
+					m_AttributeIndex++;
 					break;
 				}
 				case ShaderDataType::Mat3:
@@ -81,10 +83,16 @@ namespace GP
 		m_VertexBuffers.push_back(vertexBuffer);
 	}
 
+	void OpenGLVertexArray::SetVertexBuffer(uint32_t binding, const Ref<VertexBuffer>& vertexBuffer)
+	{
+		glVertexArrayVertexBuffer(m_RendererID, binding, vertexBuffer->GetRendererID(), 0, vertexBuffer->GetLayout().GetStride());
+		m_VertexBuffers[binding] = vertexBuffer;
+	}
+
 	void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
 	{
 		glBindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 		m_IndexBuffer = indexBuffer;
 	}
-}
+}
\ No newline at end of file
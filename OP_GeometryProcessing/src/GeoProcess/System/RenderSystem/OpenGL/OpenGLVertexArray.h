@@ -14,6 +14,7 @@ namespace GP
 		virtual void Unbind() const override;
 
 		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+		virtual void SetVertexBuffer(uint32_t binding, const Ref<VertexBuffer>& vertexBuffer) override;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const { return m_VertexBuffers; }
@@ -24,5 +25,6 @@ namespace GP
 		Ref<IndexBuffer> m_IndexBuffer;
 
 		uint32_t m_RendererID;
+		uint32_t m_AttributeIndex = 0;
 	};
 }
\ No newline at end of file
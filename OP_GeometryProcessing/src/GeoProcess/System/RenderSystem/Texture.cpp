@@ -62,4 +62,14 @@ namespace GP
 
 		return nullptr;
 	}
+
+	Ref<BufferTexture> BufferTexture::Create(uint32_t count)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::OpenGL: return std::make_shared<OpenGLBufferTexture>(count);
+		}
+
+		return nullptr;
+	}
 }
\ No newline at end of file
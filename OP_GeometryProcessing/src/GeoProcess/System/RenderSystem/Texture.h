@@ -54,4 +54,13 @@ namespace GP
 		static Ref<Texture2D> Create(const std::string& path);
 
 	};
+
+	// One float per element backed by a buffer object, read in shaders
+	// with texelFetch on a samplerBuffer (e.g. per face values indexed by
+	// gl_PrimitiveID). Width is the number of elements
+	class BufferTexture : public Texture
+	{
+	public:
+		static Ref<BufferTexture> Create(uint32_t count);
+	};
 }
\ No newline at end of file
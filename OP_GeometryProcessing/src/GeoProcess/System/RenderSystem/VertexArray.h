@@ -13,7 +13,15 @@ namespace GP
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
+		// Every vertex buffer gets its own binding and its attributes
+		// continue after the ones of the previous buffers, so a vertex
+		// array can read positions and other attributes from separate
+		// streams
 		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) = 0;
+
+		// Points an existing binding to another buffer with the same
+		// layout, switching streams does not touch the attribute setup
+		virtual void SetVertexBuffer(uint32_t binding, const Ref<VertexBuffer>& vertexBuffer) = 0;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) = 0;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const = 0;
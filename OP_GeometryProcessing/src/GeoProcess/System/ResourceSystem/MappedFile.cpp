@@ -0,0 +1,115 @@
+#include <Precomp.h>
+#include <GeoProcess/System/ResourceSystem/MappedFile.h>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace GP
+{
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			GP_ERROR("Could not open file {0} for mapping", path.string());
+			return;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			GP_ERROR("Could not create a file mapping for {0}", path.string());
+			CloseHandle(file);
+			return;
+		}
+
+		m_FileHandle = file;
+		m_MappingHandle = mapping;
+		m_Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		m_Size = size.QuadPart;
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			GP_ERROR("Could not open file {0} for mapping", path.string());
+			return;
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return;
+		}
+
+		void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			GP_ERROR("Could not map file {0}", path.string());
+			close(fd);
+			return;
+		}
+
+		m_FileDescriptor = fd;
+		m_Data = (const uint8_t*)data;
+		m_Size = info.st_size;
+#endif
+
+		if (!m_Data)
+			Close();
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	Ref<MappedFile> MappedFile::Create(const std::filesystem::path& path)
+	{
+		return std::make_shared<MappedFile>(path);
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_MappingHandle = nullptr;
+		m_FileHandle = nullptr;
+#else
+		if (m_Data)
+			munmap((void*)m_Data, m_Size);
+		if (m_FileDescriptor >= 0)
+			close(m_FileDescriptor);
+
+		m_FileDescriptor = -1;
+#endif
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+
+#include <GeoProcess/System/CoreSystem/Core.h>
+
+namespace GP
+{
+	// Read-only memory mapping of a whole file. Large binary outputs
+	// (distance matrices, cached bases) are read through this so a
+	// session can use them without loading everything into memory.
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		static Ref<MappedFile> Create(const std::filesystem::path& path);
+
+		bool IsOpen() const { return m_Data != nullptr; }
+
+		const uint8_t* GetData() const { return m_Data; }
+		uint64_t GetSize() const { return m_Size; }
+
+	private:
+		void Close();
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		uint64_t m_Size = 0;
+
+#ifdef _WIN32
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#else
+		int m_FileDescriptor = -1;
+#endif
+	};
+}
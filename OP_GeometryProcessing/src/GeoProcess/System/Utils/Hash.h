@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GP
+{
+	// Starting value of an FNV-1a hash
+	static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+	// FNV-1a over the raw bytes, used as a content key for cache files.
+	// Appending several buffers in order gives the hash of their
+	// concatenation
+	inline void AppendHash(uint64_t& hash, const void* data, uint64_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (uint64_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+}
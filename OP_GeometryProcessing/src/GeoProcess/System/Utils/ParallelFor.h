@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace GP
+{
+	// Below this many items per thread a pass is not worth starting
+	// threads for
+	static const uint32_t PARALLEL_MIN_ITEMS_PER_THREAD = 1 << 14;
+
+	// Number of ranges ParallelFor splits count items into
+	inline uint32_t GetParallelChunkCount(uint32_t count, uint32_t minItemsPerThread = PARALLEL_MIN_ITEMS_PER_THREAD)
+	{
+		static const uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+		return std::min(threadCount, std::max(1u, count / std::max(1u, minItemsPerThread)));
+	}
+
+	// Splits [0, count) into one contiguous range per thread and calls
+	// func(begin, end) on each, returning when all of them are done.
+	// Small counts run on the calling thread
+	template<typename Func>
+	void ParallelFor(uint32_t count, Func func, uint32_t minItemsPerThread = PARALLEL_MIN_ITEMS_PER_THREAD)
+	{
+		uint32_t threadCount = GetParallelChunkCount(count, minItemsPerThread);
+
+		if (threadCount == 1)
+		{
+			func(0u, count);
+			return;
+		}
+
+		uint32_t chunkSize = (count + threadCount - 1) / threadCount;
+
+		std::vector<std::future<void>> futures;
+		for (uint32_t t = 0; t < threadCount; t++)
+		{
+			uint32_t begin = t * chunkSize;
+			uint32_t end = std::min(count, begin + chunkSize);
+			if (begin >= end)
+				break;
+
+			futures.push_back(std::async(std::launch::async, func, begin, end));
+		}
+
+		for (auto& future : futures)
+			future.get();
+	}
+}